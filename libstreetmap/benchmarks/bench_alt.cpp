@@ -0,0 +1,61 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "m1.h"
+#include "m3.h"
+#include "globals.h"
+#include "routing/routing.hpp"
+#include "routing/landmarks.hpp"
+#include "benchmarks.hpp"
+
+void bench_alt (int num_queries, double turn_penalty)
+{
+    std::cout << "\n=== ALT landmarks, edge-based A* (turn penalty " << turn_penalty << ") ===" << std::endl;
+
+    std::mt19937 rng(297);
+    std::uniform_int_distribution<IntersectionIdx> pick(0, getNumIntersections() - 1);
+    std::vector<std::pair<IntersectionIdx, IntersectionIdx>> pairs;
+    for (int i = 0; i < num_queries; i++)
+    {
+        pairs.push_back(std::make_pair(pick(rng), pick(rng)));
+    }
+
+    // 0 landmarks: straight-line heuristic (baseline)
+    std::vector<double> baseline_costs;
+    for (int num_landmarks : {0, 4, 8, 16})
+    {
+        auto build_start = std::chrono::steady_clock::now();
+        init_landmarks(num_landmarks);
+        double build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start).count();
+
+        std::vector<double> latencies;
+        std::vector<double> costs;
+        long long settled = 0;
+        for (const auto& pair : pairs)
+        {
+            auto start = std::chrono::steady_clock::now();
+            costs.push_back(findPathAndTravelTime(pair, turn_penalty, PathSearchMode::EDGE_BASED).first);
+            latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            settled += last_search_stats().settled_states;
+        }
+        if (num_landmarks == 0)
+        {
+            baseline_costs = costs;
+        }
+
+        int mismatches = 0;
+        for (int i = 0; i < num_queries; i++)
+        {
+            mismatches += std::fabs(baseline_costs[i] - costs[i]) > 1e-6 * std::max(1.0, baseline_costs[i]);
+        }
+        print_latency_report("A* + " + std::to_string(num_landmarks) + " landmarks", latencies);
+        std::cout << "    preprocessing: " << build_time << "s, settled states/query: "
+                  << (double) settled / std::max(1, num_queries) << ", cost mismatches: " << mismatches << std::endl;
+    }
+
+    // Restore the landmarks m1_init computes
+    init_landmarks(NUM_LANDMARKS);
+}
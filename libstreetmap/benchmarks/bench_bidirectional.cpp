@@ -0,0 +1,82 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <numeric>
+#include <algorithm>
+
+#include "m1.h"
+#include "m3.h"
+#include "globals.h"
+#include "routing/routing.hpp"
+#include "routing/landmarks.hpp"
+#include "benchmarks.hpp"
+
+void bench_bidirectional (int num_queries, double turn_penalty)
+{
+    std::cout << "\n=== Unidirectional vs bidirectional A* (turn penalty " << turn_penalty << ") ===" << std::endl;
+
+    std::mt19937 rng(297);
+    std::uniform_int_distribution<IntersectionIdx> pick(0, getNumIntersections() - 1);
+    std::vector<std::pair<IntersectionIdx, IntersectionIdx>> pairs;
+    for (int i = 0; i < num_queries; i++)
+    {
+        pairs.push_back(std::make_pair(pick(rng), pick(rng)));
+    }
+
+    // With the straight-line heuristic and with the landmarks m1_init computes
+    for (int num_landmarks : {0, NUM_LANDMARKS})
+    {
+        init_landmarks(num_landmarks);
+        std::cout << num_landmarks << " landmarks:" << std::endl;
+
+        std::vector<double> costs[2];
+        std::vector<int> settled[2];
+        PathSearchMode modes[2] = {PathSearchMode::EDGE_BASED, PathSearchMode::BIDIRECTIONAL};
+        std::string names[2] = {"  A* (edge-based)", "  Bidirectional A*"};
+        for (int m = 0; m < 2; m++)
+        {
+            std::vector<double> latencies;
+            for (const auto& pair : pairs)
+            {
+                auto start = std::chrono::steady_clock::now();
+                costs[m].push_back(findPathAndTravelTime(pair, turn_penalty, modes[m]).first);
+                latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                settled[m].push_back(last_search_stats().settled_states);
+            }
+            print_latency_report(names[m], latencies);
+        }
+
+        // Long routes: the quarter of the queries with the longest travel time
+        std::vector<int> order(num_queries);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return costs[0][a] > costs[0][b]; });
+        int num_long = std::max(1, num_queries / 4);
+
+        double all_settled[2] = {0, 0};
+        double long_settled[2] = {0, 0};
+        for (int m = 0; m < 2; m++)
+        {
+            for (int i = 0; i < num_queries; i++)
+            {
+                all_settled[m] += settled[m][order[i]];
+                if (i < num_long)
+                {
+                    long_settled[m] += settled[m][order[i]];
+                }
+            }
+        }
+        int mismatches = 0;
+        for (int i = 0; i < num_queries; i++)
+        {
+            mismatches += std::fabs(costs[0][i] - costs[1][i]) > 1e-6 * std::max(1.0, costs[0][i]);
+        }
+        std::cout << "  settled states/query (all): " << all_settled[0] / num_queries << " --> " << all_settled[1] / num_queries
+                  << ", (longest 25%): " << long_settled[0] / num_long << " --> " << long_settled[1] / num_long
+                  << ", cost mismatches: " << mismatches << std::endl;
+    }
+
+    // Restore the landmarks m1_init computes
+    init_landmarks(NUM_LANDMARKS);
+}
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cstdio>
+
+#include "m1.h"
+#include "m3.h"
+#include "m4.h"
+#include "globals.h"
+#include "courier/courier_solver.hpp"
+#include "courier/annealing.hpp"
+#include "benchmarks.hpp"
+
+struct CourierCase
+{
+    std::vector<DeliveryInf> deliveries;
+    std::vector<IntersectionIdx> depots;
+};
+
+// Deliveries and depots of m4_func_public.simple_legality_toronto_canada.cpp (Toronto ids, turn penalty 30)
+const std::vector<CourierCase> PUBLIC_COURIER_CASES = {
+    {{{23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917}},
+     {82393, 91986, 83785}},
+    {{{33059, 39404}},
+     {8}},
+    {{{30720, 67693}, {36317, 25933}, {129351, 151543}},
+     {14501, 1618, 181726}},
+    {{{41283, 54262}, {24164, 92899}, {66787, 70120}, {150554, 155285}, {88907, 2754}},
+     {81319, 142913, 52108}},
+    {{{32645, 70504}, {45370, 30769}},
+     {86936, 109003}},
+    {{{73536, 17212}},
+     {153739, 112665}},
+    {{{119925, 5790}},
+     {169607, 161209}},
+    {{{154741, 102215}},
+     {5822}},
+    {{{31970, 120356}, {35737, 4553}},
+     {94675}},
+    {{{124331, 156932}, {25964, 156932}, {67812, 156932}, {153404, 97799}, {68424, 91419}, {94361, 91419}, {180613, 151301}, {127593, 64272}},
+     {14187, 6615, 128524}},
+    {{{42566, 168058}},
+     {35927, 36402}},
+    {{{51536, 48633}, {116224, 105642}, {37296, 57573}, {36175, 76961}, {36175, 105160}, {58813, 34544}, {36175, 154104}, {116224, 154214}},
+     {34099, 58669, 99147}},
+    {{{61863, 59982}, {94319, 91605}, {162621, 37423}, {94319, 59982}, {163417, 157781}, {61863, 157781}, {94319, 59982}, {157015, 157781}, {94319, 171145}},
+     {120, 180420, 183551}},
+    {{{64028, 16077}, {76981, 94877}, {86521, 44714}, {86521, 66147}, {2820, 27792}, {86521, 40655}, {2820, 80161}, {67514, 142237}},
+     {91400, 188386, 180980}},
+    {{{87798, 123069}, {46320, 23656}, {46284, 187909}, {26682, 187315}, {119471, 23656}, {186303, 23656}, {121158, 187315}, {157992, 140734}},
+     {19232, 147604, 28202}},
+    {{{191433, 106080}, {27861, 74592}},
+     {38703, 134104}},
+    {{{64038, 139182}, {158177, 114314}},
+     {59484}},
+    {{{118395, 34964}, {56296, 36226}, {125453, 184998}, {109945, 170985}, {9479, 152574}},
+     {171121, 145232, 43113}},
+    {{{127693, 57367}, {114452, 28017}, {12655, 175901}, {3657, 59453}, {12655, 113771}, {160388, 110274}, {12655, 33178}, {127693, 109020}},
+     {98401, 74879, 124043}},
+    {{{130185, 177203}, {29632, 50075}, {67853, 171758}},
+     {29959, 63731, 77183}},
+    {{{130308, 168964}, {117529, 54933}, {65839, 168964}, {117349, 54933}, {158825, 54933}, {183286, 116918}, {99424, 100534}, {60610, 96438}},
+     {42980, 124042, 76398}},
+    {{{153059, 158357}, {88301, 95506}, {125001, 124815}, {56466, 91817}, {92214, 19670}},
+     {65431, 110489, 18689}},
+    {{{168073, 13481}, {112155, 170357}, {34092, 146980}, {32781, 191405}, {125387, 68330}},
+     {68441, 178657, 7075}},
+    {{{174871, 19498}, {159027, 156001}, {45995, 80919}, {95061, 9005}, {18407, 146924}},
+     {184489, 68192, 49755}},
+    {{{190819, 44152}, {144100, 47529}, {67125, 44339}},
+     {74205, 64305, 178278}},
+    {{{74564, 95592}, {74564, 170932}, {40700, 80305}, {52742, 80305}, {191237, 151477}, {74564, 3167}, {74564, 3167}, {6621, 80305}, {40700, 3167}},
+     {135046, 186144, 26974}},
+    {{{80423, 70861}, {83843, 70861}, {55387, 116282}, {83140, 70861}, {69606, 90664}, {69606, 177838}, {69606, 153336}, {80423, 177838}, {69606, 177838}},
+     {133550, 77131, 171788}},
+    {{{170618, 160175}, {158972, 191403}},
+     {93042, 122131}},
+    {{{181414, 115510}, {165644, 155320}},
+     {146431}},
+    {{{181936, 73749}},
+     {152254}}
+};
+
+// Generated instances: number of deliveries and number of depots
+const std::vector<std::pair<int, int>> GENERATED_COURIER_SIZES = {{25, 3}, {50, 5}, {100, 10}, {200, 20}};
+
+// Fixed seed and move budget: the QoR of each case is the same from run to run
+const unsigned COURIER_BENCH_SEED = 297;
+const long long COURIER_BENCH_MOVES = 200000;
+
+void bench_courier (double turn_penalty)
+{
+    std::vector<std::pair<std::string, CourierCase>> cases;
+    if (CURRENT_MAP_PATH.find("toronto_canada") != std::string::npos)
+    {
+        for (int i = 0; i < PUBLIC_COURIER_CASES.size(); i++)
+        {
+            cases.emplace_back("public_" + std::to_string(i), PUBLIC_COURIER_CASES[i]);
+        }
+    }
+    std::mt19937 rng(COURIER_BENCH_SEED);
+    std::uniform_int_distribution<IntersectionIdx> pick(0, getNumIntersections() - 1);
+    for (auto [num_deliveries, num_depots] : GENERATED_COURIER_SIZES)
+    {
+        CourierCase generated;
+        for (int i = 0; i < num_deliveries; i++)
+        {
+            generated.deliveries.push_back(DeliveryInf(pick(rng), pick(rng)));
+        }
+        for (int i = 0; i < num_depots; i++)
+        {
+            generated.depots.push_back(pick(rng));
+        }
+        cases.emplace_back("generated_" + std::to_string(num_deliveries), generated);
+    }
+
+    CourierOptions options;
+    options.seed = COURIER_BENCH_SEED;
+    options.max_moves = COURIER_BENCH_MOVES;
+    options.time_budget = 45;
+
+    std::cout << "\n=== travelingCourier (turn penalty " << turn_penalty << ", seed " << COURIER_BENCH_SEED
+              << ", " << COURIER_BENCH_MOVES << " annealing moves per thread) ===" << std::endl;
+    std::cout << "case,deliveries,depots,legs,qor,seconds,moves_per_second,improvement" << std::endl;
+    for (const auto& [name, courier_case] : cases)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<CourierSubPath> result = travelingCourier(courier_case.deliveries, courier_case.depots,
+                                                              turn_penalty, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        // QoR: total travel time of the route (-1 if no route was found)
+        double qor = result.empty() ? -1 : 0;
+        for (const CourierSubPath& leg : result)
+        {
+            qor += computePathTravelTime(leg.subpath, turn_penalty);
+        }
+        // Annealing of this call (run on this thread), none if no route was found
+        AnnealingStats stats = result.empty() ? AnnealingStats() : last_annealing_stats();
+        std::printf("%s,%zu,%zu,%zu,%.3f,%.3f,%.0f,%.4f\n", name.c_str(), courier_case.deliveries.size(),
+                    courier_case.depots.size(), result.size(), qor, seconds, stats.moves_per_second(), stats.improvement());
+    }
+}
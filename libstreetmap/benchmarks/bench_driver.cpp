@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+
+#include "m1.h"
+#include "globals.h"
+#include "benchmarks.hpp"
+
+namespace ezgl {
+	extern void set_disable_event_loop (bool new_setting);
+}
+
+void print_latency_report (const std::string& name, std::vector<double> latencies_ms)
+{
+    if (latencies_ms.empty())
+    {
+        return;
+    }
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    auto percentile = [&](double p)
+    {
+        return latencies_ms[std::min(latencies_ms.size() - 1, (size_t) (p * latencies_ms.size()))];
+    };
+    std::printf("%-28s n=%-6zu p50=%9.3fms p90=%9.3fms p99=%9.3fms max=%9.3fms\n", name.c_str(), latencies_ms.size(),
+                percentile(0.50), percentile(0.90), percentile(0.99), latencies_ms.back());
+}
+
+// Usage: bench_libstreetmap [map_path] [benchmark] [num_queries]
+// benchmark: paths | alt | bidirectional | matrix | courier | all (default)
+int main(int argc, char** argv) {
+    ezgl::set_disable_event_loop(true);
+
+    std::string map_path = argc > 1 ? argv[1] : "/cad2/ece297s/public/maps/toronto_canada.streets.bin";
+    std::string benchmark = argc > 2 ? argv[2] : "all";
+    int num_queries = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+    if (!loadMap(map_path)) {
+        std::cerr << "ERROR: Could not load map file: '" << map_path << "'!" << std::endl;
+        return 1;
+    }
+    std::cout << "Loaded '" << map_path << "'" << std::endl;
+
+    if (benchmark == "paths" || benchmark == "all") {
+        bench_path_queries(num_queries, DEFAULT_TURN_PENALTY);
+    }
+    if (benchmark == "alt" || benchmark == "all") {
+        bench_alt(num_queries, DEFAULT_TURN_PENALTY);
+    }
+    if (benchmark == "bidirectional" || benchmark == "all") {
+        bench_bidirectional(num_queries, DEFAULT_TURN_PENALTY);
+    }
+    if (benchmark == "matrix" || benchmark == "all") {
+        bench_travel_time_matrix(DEFAULT_TURN_PENALTY);
+    }
+    if (benchmark == "courier" || benchmark == "all") {
+        bench_courier(DEFAULT_TURN_PENALTY);
+    }
+
+    closeMap();
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "m1.h"
+#include "m3.h"
+#include "globals.h"
+#include "routing/routing.hpp"
+#include "routing/contraction_hierarchy.hpp"
+#include "benchmarks.hpp"
+
+void bench_path_queries (int num_queries, double turn_penalty)
+{
+    std::cout << "\n=== Point-to-point queries (turn penalty " << turn_penalty << ") ===" << std::endl;
+
+    // Same random pairs for every engine
+    std::mt19937 rng(297);
+    std::uniform_int_distribution<IntersectionIdx> pick(0, getNumIntersections() - 1);
+    std::vector<std::pair<IntersectionIdx, IntersectionIdx>> pairs;
+    for (int i = 0; i < num_queries; i++)
+    {
+        pairs.push_back(std::make_pair(pick(rng), pick(rng)));
+    }
+
+    double total_ms[2] = {0, 0};
+    auto run = [&](PathSearchMode mode, std::vector<double>& costs)
+    {
+        std::vector<double> latencies;
+        for (const auto& pair : pairs)
+        {
+            auto start = std::chrono::steady_clock::now();
+            costs.push_back(findPathAndTravelTime(pair, turn_penalty, mode).first);
+            latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            total_ms[mode == PathSearchMode::CONTRACTION_HIERARCHY] += latencies.back();
+        }
+        return latencies;
+    };
+
+    std::vector<double> astar_costs;
+    print_latency_report("A* (edge-based)", run(PathSearchMode::EDGE_BASED, astar_costs));
+
+    auto build_start = std::chrono::steady_clock::now();
+    build_contraction_hierarchy(turn_penalty);
+    double build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start).count();
+    std::cout << "CH preprocessing: " << build_time << "s, " << Contraction_Hierarchy.edges.size() << " edges" << std::endl;
+
+    std::vector<double> ch_costs;
+    print_latency_report("Contraction Hierarchies", run(PathSearchMode::CONTRACTION_HIERARCHY, ch_costs));
+
+    int mismatches = 0;
+    for (int i = 0; i < num_queries; i++)
+    {
+        mismatches += std::fabs(astar_costs[i] - ch_costs[i]) > 1e-6 * std::max(1.0, astar_costs[i]);
+    }
+    // Queries the build pays for: preprocessing time / time saved per query
+    double saved_ms = (total_ms[0] - total_ms[1]) / std::max(1, num_queries);
+    std::cout << "CH query speedup: " << total_ms[0] / std::max(total_ms[1], 1e-9) << "x, break-even after ";
+    if (saved_ms > 0)
+    {
+        std::cout << (long long) (build_time * 1000 / saved_ms) << " queries" << std::endl;
+    } else
+    {
+        std::cout << "never" << std::endl;
+    }
+    std::cout << "Cost mismatches: " << mismatches << std::endl;
+    clear_contraction_hierarchy();
+}
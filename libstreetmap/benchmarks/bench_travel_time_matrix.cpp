@@ -0,0 +1,65 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "m1.h"
+#include "globals.h"
+#include "routing/contraction_hierarchy.hpp"
+#include "routing/travel_time_matrix.hpp"
+#include "benchmarks.hpp"
+
+void bench_travel_time_matrix (double turn_penalty)
+{
+    std::cout << "\n=== Many-to-many travel time matrix (turn penalty " << turn_penalty << ") ===" << std::endl;
+
+    std::mt19937 rng(297);
+    std::uniform_int_distribution<IntersectionIdx> pick(0, getNumIntersections() - 1);
+    std::vector<IntersectionIdx> points;
+    for (int i = 0; i < 200; i++)
+    {
+        points.push_back(pick(rng));
+    }
+
+    auto build_start = std::chrono::steady_clock::now();
+    build_contraction_hierarchy(turn_penalty);
+    double build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start).count();
+    std::cout << "CH preprocessing: " << build_time << "s" << std::endl;
+
+    for (int size : {25, 50, 100, 200})
+    {
+        std::vector<IntersectionIdx> subset(points.begin(), points.begin() + size);
+        double seconds[2];
+        TravelTimeMatrix matrices[2];
+        for (int use_hierarchy = 0; use_hierarchy < 2; use_hierarchy++)
+        {
+            // Without a hierarchy for the turn penalty, the one-to-many searches are used
+            double saved_penalty = Contraction_Hierarchy.turn_penalty;
+            Contraction_Hierarchy.turn_penalty = use_hierarchy ? saved_penalty : -1;
+            auto start = std::chrono::steady_clock::now();
+            matrices[use_hierarchy] = compute_travel_time_matrix(subset, subset, turn_penalty);
+            seconds[use_hierarchy] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            Contraction_Hierarchy.turn_penalty = saved_penalty;
+        }
+        int mismatches = 0;
+        for (int i = 0; i < size * size; i++)
+        {
+            mismatches += std::fabs(matrices[0].costs[i] - matrices[1].costs[i]) > 1e-3 * std::max(1.0f, matrices[0].costs[i]);
+        }
+        std::cout << size << "x" << size << ": one-to-many " << seconds[0] * 1000 << "ms, CH buckets "
+                  << seconds[1] * 1000 << "ms, cost mismatches: " << mismatches << std::endl;
+    }
+
+    // Bounded one-to-many searches: only the nearest candidates of each point
+    for (int nearest_targets : {5, 20})
+    {
+        MatrixSearchBounds bounds;
+        bounds.nearest_targets = nearest_targets;
+        auto start = std::chrono::steady_clock::now();
+        TravelTimeMatrix bounded = compute_travel_time_matrix(points, points, turn_penalty, bounds);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << points.size() << "x" << points.size() << ", " << nearest_targets << " nearest targets: "
+                  << seconds * 1000 << "ms" << std::endl;
+    }
+    clear_contraction_hierarchy();
+}
@@ -0,0 +1,32 @@
+/************************************************************
+ * BENCHMARKS
+ *
+ * Each benchmark runs on the map loaded by bench_driver.cpp
+ ************************************************************/
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+#include <vector>
+
+// Print p50 / p90 / p99 / max of the given latencies (in milliseconds)
+void print_latency_report (const std::string& name, std::vector<double> latencies_ms);
+
+// Point-to-point queries: edge-based A* against Contraction Hierarchies (including preprocessing time)
+void bench_path_queries (int num_queries, double turn_penalty);
+
+// Edge-based A* with 0 / 4 / 8 / 16 ALT landmarks: settled states, latency and preprocessing time
+void bench_alt (int num_queries, double turn_penalty);
+
+// Edge-based A* against bidirectional A*: settled states (all queries and the longest 25%) and latency
+void bench_bidirectional (int num_queries, double turn_penalty);
+
+// Travel time matrices of 25 to 200 random intersections: one-to-many searches against CH buckets
+void bench_travel_time_matrix (double turn_penalty);
+
+// travelingCourier on the public legality cases (Toronto only) and generated larger instances,
+// with a fixed seed and move budget: prints QoR and wall time of each case as CSV
+void bench_courier (double turn_penalty);
+
+#endif /* BENCHMARKS_H */
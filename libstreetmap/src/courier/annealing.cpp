@@ -0,0 +1,277 @@
+#include "courier/annealing.hpp"
+#include "courier/local_search.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <omp.h>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+// Statistics of the last annealing made by each thread
+thread_local AnnealingStats annealing_stats;
+
+// Share of the time budget kept for the final local search of each thread
+const double ANNEALING_POLISH_SHARE = 0.05;
+
+// Moves each thread evaluates between two synchronizations (temperature update, best tour shared)
+const int ANNEALING_SYNC_INTERVAL = 1000;
+
+// Annealing stops early once the best tour over all threads has not improved for this many moves per thread
+// and per pair of stops (n^2 pairs: small tours converge in a fraction of the budget, large ones use all of it)
+const int ANNEALING_STALL_MOVES_PER_PAIR = 1000;
+
+// Random moves sampled from the seed tour to pick the starting temperature
+const int TEMPERATURE_SAMPLES = 200;
+
+// Default move budget of seeded runs, per thread and per pair of stops (a few times the stall limit: the best
+// tour has time to stall before the budget runs out)
+const int ANNEALING_BUDGET_MOVES_PER_PAIR = 4 * ANNEALING_STALL_MOVES_PER_PAIR;
+
+// Threads only restart from the global best if their own best is this much longer (0.02: 2%),
+// closer threads keep searching their own part of the space
+const double ANNEALING_RESTART_MARGIN = 0.02;
+
+enum class MoveType
+{
+    OR_OPT,
+    SWAP,
+    TWO_OPT
+};
+struct AnnealingMove
+{
+    MoveType type;
+    int i;          // Or-opt: first stop moved
+    int j;          // Or-opt: position the segment is moved after
+    int length;     // Or-opt only
+};
+
+// Temperature at which an average uphill move around the tour is accepted with ANNEALING_INITIAL_ACCEPTANCE
+// (0 if no uphill move was sampled)
+double starting_temperature (const CourierTour& tour, unsigned seed);
+
+// Draw a random move, returns its delta (INFEASIBLE_MOVE if it breaks the tour)
+double random_move (const CourierTour& tour, std::mt19937& rng, AnnealingMove& move);
+void apply_move (CourierTour& tour, const AnnealingMove& move);
+
+/*******************************************************************************************************************************
+ * SIMULATED ANNEALING
+ ********************************************************************************************************************************/
+CourierTour simulated_annealing (const std::vector<CourierTour>& population,
+                                 std::chrono::steady_clock::time_point deadline,
+                                 unsigned seed,
+                                 long long max_moves,
+                                 int num_threads,
+                                 const std::function<void (const std::vector<int>& stops, double total_time)>& on_improvement)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    const CourierTour& seed_tour = population[0];
+    AnnealingStats stats;
+    stats.initial_time = seed_tour.total_time;
+    if (seed_tour.size() < 2 || start_time >= deadline)
+    {
+        stats.final_time = seed_tour.total_time;
+        annealing_stats = stats;
+        return seed_tour;
+    }
+
+    double initial_temperature = starting_temperature(seed_tour, seed);
+    double anneal_seconds = (1 - ANNEALING_POLISH_SHARE) * std::chrono::duration<double>(deadline - start_time).count();
+
+    // Shared between threads, only written inside single blocks (between barriers) or at the thread's own index
+    int max_threads = num_threads > 0 ? num_threads : omp_get_max_threads();
+    int team_size = 1;
+    std::vector<std::vector<int>> thread_best_stops(max_threads);
+    std::vector<double> thread_best_time(max_threads);
+    for (int thread = 0; thread < max_threads; thread++)
+    {
+        thread_best_stops[thread] = population[thread % population.size()].stops;
+        thread_best_time[thread] = population[thread % population.size()].total_time;
+    }
+    std::vector<CourierTour> thread_result(max_threads);
+    std::vector<long long> thread_accepted(max_threads, 0);
+    std::vector<int> global_best_stops = seed_tour.stops;
+    double global_best_time = seed_tour.total_time;
+    double progress = 0;            // Fraction of the budget (time or moves) used when the epoch started
+    long long epoch_moves = 0;      // Moves evaluated by each thread so far
+    long long improved_moves = 0;   // Value of epoch_moves when the best tour last improved
+    long long stall_moves = (long long) ANNEALING_STALL_MOVES_PER_PAIR * seed_tour.size() * seed_tour.size();
+    bool stop = initial_temperature == 0;
+
+    #pragma omp parallel num_threads(max_threads)
+    {
+        int thread = omp_get_thread_num();
+        #pragma omp single
+        team_size = omp_get_num_threads();
+
+        std::seed_seq thread_seed{seed, (unsigned) thread};
+        std::mt19937 rng(thread_seed);
+        std::uniform_real_distribution<double> unit(0, 1);
+        CourierTour tour = population[thread % population.size()];
+
+        while (!stop)
+        {
+            // One epoch: every thread evaluates ANNEALING_SYNC_INTERVAL moves at the same temperature
+            double temperature = initial_temperature * std::pow(ANNEALING_COOLING_RATIO, progress);
+            for (int iteration = 0; iteration < ANNEALING_SYNC_INTERVAL; iteration++)
+            {
+                AnnealingMove move;
+                double delta = random_move(tour, rng, move);
+                if (delta == INFEASIBLE_MOVE || (delta > 0 && unit(rng) >= std::exp(-delta / temperature)))
+                {
+                    continue;
+                }
+                apply_move(tour, move);
+                thread_accepted[thread]++;
+                if (tour.total_time < thread_best_time[thread] - IMPROVEMENT_EPSILON)
+                {
+                    thread_best_time[thread] = tour.total_time;
+                    thread_best_stops[thread] = tour.stops;
+                }
+            }
+
+            // Share the best tour over all threads (ties: lowest thread), and decide whether to go on
+            #pragma omp barrier
+            #pragma omp single
+            {
+                bool improved = false;
+                for (int other = 0; other < team_size; other++)
+                {
+                    if (thread_best_time[other] < global_best_time - IMPROVEMENT_EPSILON)
+                    {
+                        global_best_time = thread_best_time[other];
+                        global_best_stops = thread_best_stops[other];
+                        improved = true;
+                    }
+                }
+                if (improved && on_improvement)
+                {
+                    on_improvement(global_best_stops, global_best_time);
+                }
+                epoch_moves += ANNEALING_SYNC_INTERVAL;
+                if (improved)
+                {
+                    improved_moves = epoch_moves;
+                }
+                stats.stalled = epoch_moves - improved_moves >= stall_moves;
+                if (max_moves > 0)
+                {
+                    progress = (double) epoch_moves / max_moves;
+                } else
+                {
+                    progress = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count()
+                             / anneal_seconds;
+                }
+                stop = progress >= 1 || stats.stalled || std::chrono::steady_clock::now() >= deadline;
+            }
+
+            // Threads far behind the global best continue from it
+            if (!stop && thread_best_time[thread] > global_best_time * (1 + ANNEALING_RESTART_MARGIN))
+            {
+                tour.assign(*seed_tour.problem, global_best_stops);
+                thread_best_time[thread] = global_best_time;
+                thread_best_stops[thread] = global_best_stops;
+            }
+            #pragma omp barrier
+        }
+
+        // Descend from the best tour of this thread to the nearest local optimum
+        tour.assign(*seed_tour.problem, thread_best_stops[thread]);
+        local_search(tour, deadline);
+        thread_result[thread] = std::move(tour);
+    }
+
+    // Best tour over all threads (ties: lowest thread), never worse than the seed
+    CourierTour best_tour = seed_tour;
+    for (int thread = 0; thread < team_size; thread++)
+    {
+        if (thread_result[thread].total_time < best_tour.total_time - IMPROVEMENT_EPSILON)
+        {
+            best_tour = std::move(thread_result[thread]);
+        }
+        stats.moves_accepted += thread_accepted[thread];
+    }
+    stats.threads = team_size;
+    stats.moves_evaluated = epoch_moves * team_size;
+    stats.final_time = best_tour.total_time;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    annealing_stats = stats;
+    return best_tour;
+}
+
+long long annealing_move_budget (const CourierTour& tour)
+{
+    // Nearest whole number of epochs (at least one)
+    double moves = (double) ANNEALING_BUDGET_MOVES_PER_PAIR * tour.size() * tour.size();
+    return std::max(1LL, std::llround(moves / ANNEALING_SYNC_INTERVAL)) * ANNEALING_SYNC_INTERVAL;
+}
+
+const AnnealingStats& last_annealing_stats ()
+{
+    return annealing_stats;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+double starting_temperature (const CourierTour& tour, unsigned seed)
+{
+    std::mt19937 sample_rng(seed);
+    double uphill_sum = 0;
+    int uphill_count = 0;
+    for (int sample = 0; sample < TEMPERATURE_SAMPLES; sample++)
+    {
+        AnnealingMove move;
+        double delta = random_move(tour, sample_rng, move);
+        if (delta != INFEASIBLE_MOVE && delta > 0)
+        {
+            uphill_sum += delta;
+            uphill_count++;
+        }
+    }
+    return uphill_count == 0 ? 0 : -(uphill_sum / uphill_count) / std::log(ANNEALING_INITIAL_ACCEPTANCE);
+}
+
+double random_move (const CourierTour& tour, std::mt19937& rng, AnnealingMove& move)
+{
+    int n = tour.size();
+    std::uniform_int_distribution<int> position_dist(0, n - 1);
+    move.type = static_cast<MoveType>(rng() % 3);
+    move.i = position_dist(rng);
+    move.j = position_dist(rng);
+    if (move.type == MoveType::OR_OPT)
+    {
+        move.length = 1 + rng() % OR_OPT_MAX_LENGTH;
+        move.j = std::uniform_int_distribution<int>(-1, n - 1)(rng);
+        if (move.i + move.length > n || (move.j >= move.i - 1 && move.j < move.i + move.length))
+        {
+            return INFEASIBLE_MOVE;
+        }
+        return tour.or_opt_delta(move.i, move.length, move.j);
+    }
+
+    if (move.i == move.j)
+    {
+        return INFEASIBLE_MOVE;
+    }
+    if (move.i > move.j)
+    {
+        std::swap(move.i, move.j);
+    }
+    return move.type == MoveType::SWAP ? tour.swap_delta(move.i, move.j) : tour.two_opt_delta(move.i, move.j);
+}
+
+void apply_move (CourierTour& tour, const AnnealingMove& move)
+{
+    if (move.type == MoveType::OR_OPT)
+    {
+        tour.apply_or_opt(move.i, move.length, move.j);
+    } else if (move.type == MoveType::SWAP)
+    {
+        tour.apply_swap(move.i, move.j);
+    } else
+    {
+        tour.apply_two_opt(move.i, move.j);
+    }
+}
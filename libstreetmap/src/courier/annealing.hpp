@@ -0,0 +1,78 @@
+/************************************************************
+ * COURIER SIMULATED ANNEALING
+ *
+ * Every thread anneals its own tour of the starting population
+ * (thread t: tour t modulo the population size) with its own
+ * random stream: random relocate, Or-opt, swap and 2-opt moves are
+ * accepted when they improve the tour, or with probability
+ * exp(-delta / T) otherwise. The temperature T falls geometrically
+ * with the fraction of the budget used, so the search moves freely
+ * at first and only descends near the end. It stops early once the
+ * best tour has not improved for a number of moves that grows with
+ * the square of the tour size.
+ *
+ * Threads run in epochs of a fixed number of moves. Between epochs
+ * they synchronize: the best tour over all threads is shared, and
+ * threads far behind it (ANNEALING_RESTART_MARGIN) continue from it,
+ * the others keep searching on their own. The best tour of each
+ * thread is finally polished with local_search.
+ ************************************************************/
+
+#ifndef ANNEALING_H
+#define ANNEALING_H
+
+#include <chrono>
+#include <functional>
+#include "courier/courier_tour.hpp"
+
+// Starting temperature: an average uphill move is accepted with this probability
+const double ANNEALING_INITIAL_ACCEPTANCE = 0.5;
+// Final temperature / starting temperature
+const double ANNEALING_COOLING_RATIO = 1e-3;
+
+struct AnnealingStats
+{
+    int threads = 0;
+    long long moves_evaluated = 0;  // Over all threads
+    long long moves_accepted = 0;
+    double seconds = 0;
+    double initial_time = 0;        // Travel time of the best tour of the population
+    double final_time = 0;          // Travel time of the best tour found
+    bool stalled = false;           // Stopped early: the best tour no longer improved
+
+    double moves_per_second () const
+    {
+        return seconds > 0 ? moves_evaluated / seconds : 0;
+    }
+    double improvement () const
+    {
+        return initial_time > 0 ? (initial_time - final_time) / initial_time : 0;
+    }
+};
+
+// Anneal the population (not empty, best first) on every thread, returns the best tour found by any thread
+// (never worse than the best of the population).
+// Runs on num_threads threads (0: OpenMP default), thread t draws its moves from a generator seeded with (seed, t).
+// on_improvement (optional) is called by one thread, at synchronizations, with the stops and travel time of each
+// better tour shared, while the other threads wait: it should only copy them
+// max_moves == 0: cool with the time left until the deadline
+// max_moves > 0:  cool with the moves evaluated by each thread, and stop after max_moves of them
+//                 (same seed and thread count --> same tour, as long as the deadline is not reached)
+// Either way, stops early once the best tour stalls
+CourierTour simulated_annealing (const std::vector<CourierTour>& population,
+                                 std::chrono::steady_clock::time_point deadline,
+                                 unsigned seed,
+                                 long long max_moves = 0,
+                                 int num_threads = 0,
+                                 const std::function<void (const std::vector<int>& stops, double total_time)>& on_improvement
+                                     = nullptr);
+
+// Move budget per thread (for max_moves) from the tour size only: grows with the square of the number of stops,
+// rounded to the nearest whole number of epochs. Never depends on the machine, so a seed alone fixes the tour
+// (the deadline still stops the annealing if the budget does not fit)
+long long annealing_move_budget (const CourierTour& tour);
+
+// Statistics of the last annealing run by the calling thread
+const AnnealingStats& last_annealing_stats ();
+
+#endif /* ANNEALING_H */
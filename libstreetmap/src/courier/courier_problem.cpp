@@ -0,0 +1,102 @@
+#include "courier/courier_problem.hpp"
+#include "routing/path_cache.hpp"
+#include <unordered_map>
+
+CourierProblem build_courier_problem (const std::vector<DeliveryInf>& deliveries,
+                                      const std::vector<IntersectionIdx>& depots,
+                                      float turn_penalty)
+{
+    CourierProblem problem;
+    problem.num_deliveries = deliveries.size();
+    problem.pick_point.resize(deliveries.size());
+    problem.drop_point.resize(deliveries.size());
+
+    // Each distinct intersection gets one point, pickUp/dropOff points before depots
+    std::unordered_map<IntersectionIdx, int> point_index;
+    auto add_point = [&](IntersectionIdx intersection)
+    {
+        auto inserted = point_index.insert(std::make_pair(intersection, (int) problem.points.size()));
+        if (inserted.second)
+        {
+            problem.points.push_back(intersection);
+        }
+        return inserted.first->second;
+    };
+    for (int i = 0; i < deliveries.size(); i++)
+    {
+        problem.pick_point[i] = add_point(deliveries[i].pickUp);
+        problem.drop_point[i] = add_point(deliveries[i].dropOff);
+    }
+    problem.num_delivery_points = problem.points.size();
+    for (IntersectionIdx depot : depots)
+    {
+        add_point(depot);
+    }
+
+    // Deliveries of each point in CSR form
+    auto fill_lists = [&](const std::vector<int>& delivery_point, std::vector<int>& offsets, std::vector<int>& ids)
+    {
+        offsets.assign(problem.points.size() + 1, 0);
+        for (int point : delivery_point)
+        {
+            offsets[point + 1]++;
+        }
+        for (int point = 0; point < problem.points.size(); point++)
+        {
+            offsets[point + 1] += offsets[point];
+        }
+        ids.resize(delivery_point.size());
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (int i = 0; i < delivery_point.size(); i++)
+        {
+            ids[fill[delivery_point[i]]++] = i;
+        }
+    };
+    fill_lists(problem.pick_point, problem.pick_offsets, problem.pick_ids);
+    fill_lists(problem.drop_point, problem.drop_offsets, problem.drop_ids);
+
+    problem.travel_times = cached_travel_time_matrix(problem.points, turn_penalty);
+
+    problem.start_depot.assign(problem.points.size(), -1);
+    problem.end_depot.assign(problem.points.size(), -1);
+    for (int point = 0; point < problem.points.size(); point++)
+    {
+        for (int depot = problem.num_delivery_points; depot < problem.points.size(); depot++)
+        {
+            if (problem.has_path(depot, point)
+                && (problem.start_depot[point] == -1 || problem.cost(depot, point) < problem.start_cost(point)))
+            {
+                problem.start_depot[point] = depot;
+            }
+            if (problem.has_path(point, depot)
+                && (problem.end_depot[point] == -1 || problem.cost(point, depot) < problem.end_cost(point)))
+            {
+                problem.end_depot[point] = depot;
+            }
+        }
+    }
+    return problem;
+}
+
+std::vector<CourierSubPath> courier_result (const CourierProblem& problem, const std::vector<int>& route)
+{
+    std::vector<std::pair<int, int>> legs;
+    for (int i = 0; i + 1 < route.size(); i++)
+    {
+        if (route[i] != route[i + 1])
+        {
+            legs.push_back(std::make_pair(route[i], route[i + 1]));
+        }
+    }
+
+    // Routes are only rebuilt for the legs of the final path, independently of each other
+    std::vector<CourierSubPath> result(legs.size());
+    #pragma omp parallel for
+    for (int i = 0; i < legs.size(); i++)
+    {
+        result[i] = {problem.points[legs[i].first],
+                     problem.points[legs[i].second],
+                     cached_path(problem.travel_times, legs[i].first, legs[i].second)};
+    }
+    return result;
+}
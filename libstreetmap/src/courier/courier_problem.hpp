@@ -0,0 +1,82 @@
+/************************************************************
+ * COURIER PROBLEM
+ *
+ * Dense form of a travelingCourier instance: every pickUp/dropOff
+ * intersection and depot is remapped once to an index 0..N-1, so the
+ * optimization works on a contiguous float matrix and flat arrays,
+ * and only the final result is translated back to IntersectionIdx.
+ ************************************************************/
+
+#ifndef COURIER_PROBLEM_H
+#define COURIER_PROBLEM_H
+
+#include "m1.h"
+#include "m4.h"
+#include "globals.h"
+#include "routing/travel_time_matrix.hpp"
+
+struct CourierProblem
+{
+    int num_deliveries = 0;
+    // Index: point, Value: intersection
+    // Points [0, num_delivery_points) are pickUp/dropOff intersections, the rest are depots
+    std::vector<IntersectionIdx> points;
+    int num_delivery_points = 0;
+
+    // Deliveries picked up / dropped off at each point: pick_ids[pick_offsets[point] .. pick_offsets[point + 1])
+    // A delivery with its pickUp and dropOff at the same intersection is in both lists of that point
+    std::vector<int> pick_offsets;
+    std::vector<int> pick_ids;
+    std::vector<int> drop_offsets;
+    std::vector<int> drop_ids;
+    // Index: delivery, Value: point
+    std::vector<int> pick_point;
+    std::vector<int> drop_point;
+
+    // Travel times between all points (FLT_MAX if no path), paths of the final legs are rebuilt from it
+    // Both go through the path cache (see routing/path_cache.hpp)
+    TravelTimeMatrix travel_times;
+    // Index: point, Value: closest depot to start from / end at (-1 if no depot is reachable)
+    std::vector<int> start_depot;
+    std::vector<int> end_depot;
+
+    int num_points () const
+    {
+        return points.size();
+    }
+    bool is_depot (int point) const
+    {
+        return point >= num_delivery_points;
+    }
+    bool has_pickup (int point) const
+    {
+        return pick_offsets[point + 1] > pick_offsets[point];
+    }
+    float cost (int from, int to) const
+    {
+        return travel_times.costs[from * points.size() + to];
+    }
+    bool has_path (int from, int to) const
+    {
+        return cost(from, to) < FLT_MAX;
+    }
+    float start_cost (int point) const
+    {
+        return start_depot[point] == -1 ? FLT_MAX : cost(start_depot[point], point);
+    }
+    float end_cost (int point) const
+    {
+        return end_depot[point] == -1 ? FLT_MAX : cost(point, end_depot[point]);
+    }
+};
+
+// Remap the deliveries and depots to dense points and compute the travel times between all of them
+CourierProblem build_courier_problem (const std::vector<DeliveryInf>& deliveries,
+                                      const std::vector<IntersectionIdx>& depots,
+                                      float turn_penalty);
+
+// Courier sub-paths (with street segments) between consecutive points of a route
+// Legs between two visits of the same intersection are skipped
+std::vector<CourierSubPath> courier_result (const CourierProblem& problem, const std::vector<int>& route);
+
+#endif /* COURIER_PROBLEM_H */
@@ -0,0 +1,64 @@
+/************************************************************
+ * COURIER SOLVER OPTIONS
+ *
+ * travelingCourier (m4.h) runs with the default options. Fixing the
+ * seed and giving a move budget makes results reproducible, so that
+ * changes to the solver can be compared on quality of result.
+ *
+ * travelingCourierUntil is the anytime form: it runs until a deadline,
+ * returns the best legal route found by then, and can report every
+ * better route found on the way (e.g. to send a first answer early).
+ ************************************************************/
+
+#ifndef COURIER_SOLVER_H
+#define COURIER_SOLVER_H
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include "m4.h"
+
+// How travelingCourier improves its greedy tour
+enum class CourierImprovement
+{
+    LOCAL_SEARCH,           // Descent to the first local optimum only
+    SIMULATED_ANNEALING     // Anneal until the time budget runs out or the best tour stalls
+};
+
+struct CourierOptions
+{
+    std::optional<unsigned> seed;   // Random seed (none: seeded from std::random_device)
+    int num_threads = 0;            // Threads of the greedy and improvement stages (0: OpenMP default)
+    double time_budget = 10;        // Seconds for the whole call at most, pre-computation included
+                                    // (annealing stops early once it no longer finds better tours)
+    int population_size = 32;       // Insertion constructions run to seed the improvement phase
+    CourierImprovement improvement = CourierImprovement::SIMULATED_ANNEALING;
+    // > 0: annealing stops after this many moves per thread instead of cooling with the clock
+    // (with a fixed seed and thread count, results are then the same from run to run)
+    // 0 with a seed: a budget from the number of stops (annealing_move_budget), 0 without: the clock
+    long long max_moves = 0;
+};
+
+// Called with better legal routes found (same format as the result) and their travel time, from another thread
+// than the search: neither the search nor the return of the result waits for it. Calls are never concurrent and each
+// one reports a shorter route than the last; routes found while a call runs are skipped except the last one.
+// The final (returned) route is always reported, possibly after travelingCourierUntil returned: the callback is
+// copied, and what it refers to must outlive it
+using CourierImprovementCallback = std::function<void (const std::vector<CourierSubPath>& route, double travel_time)>;
+
+std::vector<CourierSubPath> travelingCourier (const std::vector<DeliveryInf>& deliveries,
+                                              const std::vector<IntersectionIdx>& depots,
+                                              const float turn_penalty,
+                                              const CourierOptions& options);
+
+// Improve until the deadline (options.time_budget is ignored) or until annealing stalls. The travel time matrix and at least
+// one greedy route are always computed, even past the deadline; if no legal route exists the result is empty.
+// The time the greedy route took to rebuild into street segments is kept in reserve for the final route
+std::vector<CourierSubPath> travelingCourierUntil (const std::vector<DeliveryInf>& deliveries,
+                                                   const std::vector<IntersectionIdx>& depots,
+                                                   const float turn_penalty,
+                                                   const std::chrono::steady_clock::time_point deadline,
+                                                   const CourierOptions& options = CourierOptions(),
+                                                   const CourierImprovementCallback& on_improvement = nullptr);
+
+#endif /* COURIER_SOLVER_H */
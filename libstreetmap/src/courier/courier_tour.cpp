@@ -0,0 +1,203 @@
+#include "courier/courier_tour.hpp"
+#include <algorithm>
+
+void CourierTour::assign (const CourierProblem& courier_problem, const std::vector<int>& new_stops, int route_depot)
+{
+    problem = &courier_problem;
+    stops = new_stops;
+    depot = route_depot;
+    update();
+}
+
+void CourierTour::update ()
+{
+    int n = stops.size();
+    // Stops of every delivery have a slot (a route of a fleet holds only some of them)
+    position.assign(2 * problem->num_deliveries, -1);
+    forward_prefix.resize(n);
+    reverse_prefix.resize(n);
+    load.resize(n);
+    for (int pos = 0; pos < n; pos++)
+    {
+        position[stops[pos]] = pos;
+        forward_prefix[pos] = pos == 0 ? 0 : forward_prefix[pos - 1] + problem->cost(point(pos - 1), point(pos));
+        reverse_prefix[pos] = pos == 0 ? 0 : reverse_prefix[pos - 1] + problem->cost(point(pos), point(pos - 1));
+        load[pos] = (pos == 0 ? 0 : load[pos - 1]) + (is_pickup_stop(stops[pos]) ? 1 : -1);
+    }
+    total_time = n == 0 ? 0 : leg(-1, 0) + forward_prefix[n - 1] + leg(n - 1, n);
+
+    // Sparse table: level 0 holds the pickUp position of each dropOff
+    pickup_max.resize(1);
+    pickup_max[0].resize(n);
+    for (int pos = 0; pos < n; pos++)
+    {
+        pickup_max[0][pos] = is_pickup_stop(stops[pos]) ? -1 : position[partner_stop(stops[pos])];
+    }
+    for (int level = 1; (1 << level) <= n; level++)
+    {
+        pickup_max.resize(level + 1);
+        pickup_max[level].resize(n - (1 << level) + 1);
+        for (int pos = 0; pos + (1 << level) <= n; pos++)
+        {
+            pickup_max[level][pos] = std::max(pickup_max[level - 1][pos], pickup_max[level - 1][pos + (1 << (level - 1))]);
+        }
+    }
+}
+
+double CourierTour::leg (int from, int to) const
+{
+    if (from == -1)
+    {
+        return depot == -1 ? problem->start_cost(point(to)) : problem->cost(depot, point(to));
+    }
+    if (to == size())
+    {
+        return depot == -1 ? problem->end_cost(point(from)) : problem->cost(point(from), depot);
+    }
+    return problem->cost(point(from), point(to));
+}
+
+double CourierTour::or_opt_delta (int first, int length, int after) const
+{
+    int last = first + length - 1;
+    int n = size();
+    if (length <= 0 || last >= n || after < -1 || after >= n || (after >= first - 1 && after <= last))
+    {
+        return INFEASIBLE_MOVE;
+    }
+
+    // Moving later: no dropOff passed over may belong to a pickUp of the segment
+    // Moving earlier: no pickUp passed over may belong to a dropOff of the segment
+    for (int pos = first; pos <= last; pos++)
+    {
+        int partner = position[partner_stop(stops[pos])];
+        if (after > last && is_pickup_stop(stops[pos]) && partner > last && partner <= after)
+        {
+            return INFEASIBLE_MOVE;
+        }
+        if (after < first && !is_pickup_stop(stops[pos]) && partner > after && partner < first)
+        {
+            return INFEASIBLE_MOVE;
+        }
+    }
+
+    // Close the gap, then open the tour between after and after + 1
+    double delta = leg(first - 1, last + 1) - leg(first - 1, first) - leg(last, last + 1);
+    delta += leg(after, first) + leg(last, after + 1) - leg(after, after + 1);
+    return delta;
+}
+
+double CourierTour::swap_delta (int i, int j) const
+{
+    if (i >= j || i < 0 || j >= size())
+    {
+        return INFEASIBLE_MOVE;
+    }
+    // stops[i] moves later to j, stops[j] moves earlier to i
+    if (is_pickup_stop(stops[i]) && position[partner_stop(stops[i])] <= j)
+    {
+        return INFEASIBLE_MOVE;
+    }
+    if (!is_pickup_stop(stops[j]) && position[partner_stop(stops[j])] >= i)
+    {
+        return INFEASIBLE_MOVE;
+    }
+
+    if (j == i + 1)
+    {
+        return leg(i - 1, j) + leg(j, i) + leg(i, j + 1) - leg(i - 1, i) - leg(i, j) - leg(j, j + 1);
+    }
+    return leg(i - 1, j) + leg(j, i + 1) + leg(j - 1, i) + leg(i, j + 1)
+         - leg(i - 1, i) - leg(i, i + 1) - leg(j - 1, j) - leg(j, j + 1);
+}
+
+double CourierTour::two_opt_delta (int i, int j) const
+{
+    if (i >= j || i < 0 || j >= size())
+    {
+        return INFEASIBLE_MOVE;
+    }
+    // Reversing is only legal if no delivery has both stops inside [i, j]
+    int level = 31 - __builtin_clz(j - i + 1);
+    if (std::max(pickup_max[level][i], pickup_max[level][j - (1 << level) + 1]) >= i)
+    {
+        return INFEASIBLE_MOVE;
+    }
+
+    double forward_inside = forward_prefix[j] - forward_prefix[i];
+    double reverse_inside = reverse_prefix[j] - reverse_prefix[i];
+    return leg(i - 1, j) + reverse_inside + leg(i, j + 1) - leg(i - 1, i) - forward_inside - leg(j, j + 1);
+}
+
+void CourierTour::apply_or_opt (int first, int length, int after)
+{
+    std::vector<int> segment(stops.begin() + first, stops.begin() + first + length);
+    if (after > first)
+    {
+        // Shift the stops in between towards the front
+        std::copy(stops.begin() + first + length, stops.begin() + after + 1, stops.begin() + first);
+        std::copy(segment.begin(), segment.end(), stops.begin() + after - length + 1);
+    } else
+    {
+        std::copy_backward(stops.begin() + after + 1, stops.begin() + first, stops.begin() + first + length);
+        std::copy(segment.begin(), segment.end(), stops.begin() + after + 1);
+    }
+    update();
+}
+
+void CourierTour::apply_swap (int i, int j)
+{
+    std::swap(stops[i], stops[j]);
+    update();
+}
+
+void CourierTour::apply_two_opt (int i, int j)
+{
+    std::reverse(stops.begin() + i, stops.begin() + j + 1);
+    update();
+}
+
+std::vector<int> CourierTour::route () const
+{
+    std::vector<int> points;
+    if (stops.empty())
+    {
+        return points;
+    }
+    points.push_back(depot == -1 ? problem->start_depot[point(0)] : depot);
+    for (int pos = 0; pos < size(); pos++)
+    {
+        points.push_back(point(pos));
+    }
+    points.push_back(depot == -1 ? problem->end_depot[point(size() - 1)] : depot);
+    return points;
+}
+
+std::vector<int> stops_from_route (const CourierProblem& problem, const std::vector<int>& route)
+{
+    std::vector<int> stops;
+    std::vector<char> picked(problem.num_deliveries, 0);
+    std::vector<char> dropped(problem.num_deliveries, 0);
+    for (int point : route)
+    {
+        for (int i = problem.pick_offsets[point]; i < problem.pick_offsets[point + 1]; i++)
+        {
+            int delivery = problem.pick_ids[i];
+            if (!picked[delivery])
+            {
+                picked[delivery] = 1;
+                stops.push_back(pickup_stop(delivery));
+            }
+        }
+        for (int i = problem.drop_offsets[point]; i < problem.drop_offsets[point + 1]; i++)
+        {
+            int delivery = problem.drop_ids[i];
+            if (picked[delivery] && !dropped[delivery])
+            {
+                dropped[delivery] = 1;
+                stops.push_back(dropoff_stop(delivery));
+            }
+        }
+    }
+    return stops;
+}
@@ -0,0 +1,103 @@
+/************************************************************
+ * COURIER TOUR
+ *
+ * A courier route as a sequence of stops: stop 2 * d picks up
+ * delivery d and stop 2 * d + 1 drops it off. The route starts at
+ * the closest depot to its first stop and ends at the closest depot
+ * to its last stop, or starts and ends at a fixed depot (vehicles
+ * of a fleet).
+ *
+ * Prefix travel times (both walking directions) and a range-max
+ * table over pickUp positions are kept up to date, so relocate,
+ * Or-opt, swap and 2-opt moves are checked for pickUp --> dropOff
+ * order and costed in constant time (Or-opt: segment length).
+ * Applying a move rebuilds them in O(n log n).
+ ************************************************************/
+
+#ifndef COURIER_TOUR_H
+#define COURIER_TOUR_H
+
+#include <algorithm>
+#include <cfloat>
+#include "courier/courier_problem.hpp"
+
+// Delta returned for moves that break the pickUp --> dropOff order of some delivery
+const double INFEASIBLE_MOVE = DBL_MAX;
+
+inline int pickup_stop (int delivery)
+{
+    return 2 * delivery;
+}
+inline int dropoff_stop (int delivery)
+{
+    return 2 * delivery + 1;
+}
+inline bool is_pickup_stop (int stop)
+{
+    return stop % 2 == 0;
+}
+// The other stop of the same delivery
+inline int partner_stop (int stop)
+{
+    return stop ^ 1;
+}
+
+struct CourierTour
+{
+    const CourierProblem* problem = nullptr;
+    std::vector<int> stops;                 // Index: position, Value: stop
+    std::vector<int> position;              // Index: stop, Value: position (-1 if not in the tour)
+    // forward_prefix[k]: travel time stops[0] -> stops[k] along the tour
+    // reverse_prefix[k]: travel time stops[k] -> stops[0] visiting the same stops backwards
+    std::vector<double> forward_prefix;
+    std::vector<double> reverse_prefix;
+    std::vector<int> load;                  // Index: position, Value: packages carried when leaving the stop
+    // pickup_max[level][k]: latest pickUp position of the dropOffs at positions [k, k + 2^level) (-1 if none)
+    std::vector<std::vector<int>> pickup_max;
+    double total_time = 0;                  // Including the legs from / to the depots
+    int depot = -1;                         // Point the route starts and ends at (-1: closest depots)
+
+    // Take the given stops (every delivery exactly once, pickUp first) and build the prefix data
+    void assign (const CourierProblem& courier_problem, const std::vector<int>& new_stops, int route_depot = -1);
+    // Rebuild the prefix data after stops changed
+    void update ();
+
+    int size () const
+    {
+        return stops.size();
+    }
+    // Point visited at a position
+    int point (int pos) const
+    {
+        int delivery = stops[pos] / 2;
+        return is_pickup_stop(stops[pos]) ? problem->pick_point[delivery] : problem->drop_point[delivery];
+    }
+    // Most packages carried at once
+    int max_load () const
+    {
+        return load.empty() ? 0 : *std::max_element(load.begin(), load.end());
+    }
+    // Travel time between two positions of the tour (-1: start depot, size(): end depot)
+    double leg (int from, int to) const;
+
+    // Change in total_time (< 0: improvement) or INFEASIBLE_MOVE
+    // Or-opt: move stops [first, first + length) right after position after (-1: to the front), keeping their order
+    // Relocate is Or-opt of length 1
+    double or_opt_delta (int first, int length, int after) const;
+    // Swap the stops at positions i < j
+    double swap_delta (int i, int j) const;
+    // Reverse the stops at positions [i, j]
+    double two_opt_delta (int i, int j) const;
+
+    void apply_or_opt (int first, int length, int after);
+    void apply_swap (int i, int j);
+    void apply_two_opt (int i, int j);
+
+    // Points of the whole route, depots included
+    std::vector<int> route () const;
+};
+
+// Stops in the order a route of points handles them (pickUps then dropOffs at each visit)
+std::vector<int> stops_from_route (const CourierProblem& problem, const std::vector<int>& route);
+
+#endif /* COURIER_TOUR_H */
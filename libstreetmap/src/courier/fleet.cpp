@@ -0,0 +1,445 @@
+#include "courier/fleet.hpp"
+#include "courier/courier_problem.hpp"
+#include "courier/courier_tour.hpp"
+#include "courier/insertion.hpp"
+#include "courier/local_search.hpp"
+#include <algorithm>
+#include <random>
+#include <omp.h>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+// Constructions after the first MAX_REGRET_K ones scale insertion costs by a random factor in [1 - noise, 1 + noise]
+const double FLEET_CONSTRUCTION_NOISE = 0.1;
+
+struct FleetPlan
+{
+    std::vector<CourierTour> routes;    // Index: vehicle (empty if no plan was found)
+    double total_time = 0;
+    double makespan = 0;
+
+    void update_times ()
+    {
+        total_time = 0;
+        makespan = 0;
+        for (const CourierTour& route : routes)
+        {
+            total_time += route.total_time;
+            makespan = std::max(makespan, route.total_time);
+        }
+    }
+};
+
+// A route as the input of best_insertion: point and load of each position
+struct RouteShape
+{
+    std::vector<int> points;
+    std::vector<int> loads;
+};
+
+// Whether (total_a, makespan_a) is better than (total_b, makespan_b) for the objective
+bool better_plan (double total_a, double makespan_a, double total_b, double makespan_b, FleetObjective objective);
+
+// Point of the depot of each vehicle, empty if vehicle_depots is not valid
+std::vector<int> vehicle_depot_points (const CourierProblem& problem, const std::vector<IntersectionIdx>& depots,
+                                       const FleetOptions& fleet);
+
+// Build a plan by regret insertion over the vehicles (regret between the best routes of each delivery),
+// the route of vehicle v starting and ending at depot_points[v]
+FleetPlan construct_fleet (const CourierProblem& problem, const FleetOptions& fleet, const std::vector<int>& depot_points,
+                           int regret_k, double noise, unsigned seed);
+
+// Apply the first improving move that relocates one delivery to another route, or exchanges
+// two deliveries of different routes. Returns true if a move was applied
+bool improve_relocate (const CourierProblem& problem, FleetPlan& plan, const FleetOptions& fleet,
+                       std::chrono::steady_clock::time_point deadline);
+bool improve_exchange (const CourierProblem& problem, FleetPlan& plan, const FleetOptions& fleet,
+                       std::chrono::steady_clock::time_point deadline);
+
+RouteShape route_shape (const CourierTour& route);
+
+// Same route (same depot) without one delivery
+CourierTour remove_delivery (const CourierTour& route, int delivery);
+
+// Route with one delivery inserted where best_insertion placed it
+CourierTour add_delivery (const CourierProblem& problem, const CourierTour& route, const RouteShape& shape,
+                          int delivery, const Insertion& insertion);
+
+/*******************************************************************************************************************************
+ * FLEET ROUTING
+ ********************************************************************************************************************************/
+std::vector<std::vector<CourierSubPath>> travelingCouriers (const std::vector<DeliveryInf>& deliveries,
+                                                           const std::vector<IntersectionIdx>& depots,
+                                                           const float turn_penalty,
+                                                           const FleetOptions& fleet,
+                                                           const CourierOptions& options)
+{
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(options.time_budget));
+    int num_threads = options.num_threads > 0 ? options.num_threads : omp_get_max_threads();
+    unsigned seed = options.seed ? *options.seed : std::random_device{}();
+    CourierProblem problem = build_courier_problem(deliveries, depots, turn_penalty);
+    std::vector<int> depot_points = vehicle_depot_points(problem, depots, fleet);
+    if (depot_points.empty())
+    {
+        return {};
+    }
+
+    // Constructions in parallel: regret-2, regret-3, cheapest insertion, then the same with random noise
+    int num_constructions = std::max(1, options.population_size);
+    std::vector<FleetPlan> constructed(num_constructions);
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for (int construction = 0; construction < num_constructions; construction++)
+    {
+        if (construction > 0 && std::chrono::steady_clock::now() >= deadline)
+        {
+            continue;
+        }
+        int regret_k = 1 + (construction + 1) % MAX_REGRET_K;
+        double noise = construction < MAX_REGRET_K ? 0 : FLEET_CONSTRUCTION_NOISE;
+        constructed[construction] = construct_fleet(problem, fleet, depot_points, regret_k, noise, seed + construction);
+    }
+
+    // Best plan (ties: first construction)
+    int best = -1;
+    for (int construction = 0; construction < num_constructions; construction++)
+    {
+        const FleetPlan& plan = constructed[construction];
+        if (!plan.routes.empty() && (best == -1 || better_plan(plan.total_time, plan.makespan, constructed[best].total_time,
+                                                               constructed[best].makespan, fleet.objective)))
+        {
+            best = construction;
+        }
+    }
+    if (best == -1)
+    {
+        return {};
+    }
+    FleetPlan plan = std::move(constructed[best]);
+
+    // Each route to its local optimum (in parallel), then one move between routes, until none improves
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+        for (int vehicle = 0; vehicle < plan.routes.size(); vehicle++)
+        {
+            local_search(plan.routes[vehicle], deadline, fleet.capacity);
+        }
+        plan.update_times();
+        if (!improve_relocate(problem, plan, fleet, deadline) && !improve_exchange(problem, plan, fleet, deadline))
+        {
+            break;
+        }
+    }
+
+    std::vector<std::vector<CourierSubPath>> result(plan.routes.size());
+    for (int vehicle = 0; vehicle < plan.routes.size(); vehicle++)
+    {
+        if (plan.routes[vehicle].size() > 0)
+        {
+            result[vehicle] = courier_result(problem, plan.routes[vehicle].route());
+        }
+    }
+    return result;
+}
+
+/*******************************************************************************************************************************
+ * CONSTRUCTION & MOVES
+ ********************************************************************************************************************************/
+FleetPlan construct_fleet (const CourierProblem& problem, const FleetOptions& fleet, const std::vector<int>& depot_points,
+                           int regret_k, double noise, unsigned seed)
+{
+    int num_vehicles = depot_points.size();
+    FleetPlan plan;
+    plan.routes.resize(num_vehicles);
+    std::vector<RouteShape> shapes(num_vehicles);
+    for (int vehicle = 0; vehicle < num_vehicles; vehicle++)
+    {
+        plan.routes[vehicle].assign(problem, {}, depot_points[vehicle]);
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> noise_factor(1 - noise, 1 + noise);
+    std::vector<char> inserted(problem.num_deliveries, 0);
+    for (int step = 0; step < problem.num_deliveries; step++)
+    {
+        // Key of a route: added travel time (total time) or travel time of the route after the insertion (makespan)
+        // Largest regret over the k best routes first, then smallest key (ties: lowest delivery, lowest vehicle)
+        int chosen = -1;
+        int chosen_vehicle = -1;
+        Insertion chosen_insertion;
+        double chosen_regret = 0;
+        double chosen_key = 0;
+        for (int delivery = 0; delivery < problem.num_deliveries; delivery++)
+        {
+            if (inserted[delivery])
+            {
+                continue;
+            }
+            double cheapest[MAX_REGRET_K];
+            std::fill(cheapest, cheapest + MAX_REGRET_K, NO_INSERTION);
+            int best_vehicle = -1;
+            Insertion best_vehicle_insertion;
+            for (int vehicle = 0; vehicle < num_vehicles; vehicle++)
+            {
+                Insertion insertion = best_insertion(problem, shapes[vehicle].points, shapes[vehicle].loads,
+                                                     fleet.capacity, delivery, 1, plan.routes[vehicle].depot);
+                if (insertion.cost == NO_INSERTION)
+                {
+                    continue;
+                }
+                double key = fleet.objective == FleetObjective::MAKESPAN ? plan.routes[vehicle].total_time + insertion.cost
+                                                                         : insertion.cost;
+                if (noise > 0)
+                {
+                    key *= noise_factor(rng);
+                }
+                if (best_vehicle == -1 || key < cheapest[0])
+                {
+                    best_vehicle = vehicle;
+                    best_vehicle_insertion = insertion;
+                }
+                for (int rank = 0; rank < regret_k; rank++)
+                {
+                    if (key < cheapest[rank])
+                    {
+                        std::swap(key, cheapest[rank]);
+                    }
+                }
+            }
+            // The delivery fits in no route
+            if (best_vehicle == -1)
+            {
+                return FleetPlan();
+            }
+
+            double regret = regret_k == 1 ? -cheapest[0] : 0;
+            for (int rank = 1; rank < regret_k; rank++)
+            {
+                regret += cheapest[rank] - cheapest[0];
+            }
+            if (chosen == -1 || regret > chosen_regret || (regret == chosen_regret && cheapest[0] < chosen_key))
+            {
+                chosen = delivery;
+                chosen_vehicle = best_vehicle;
+                chosen_insertion = best_vehicle_insertion;
+                chosen_regret = regret;
+                chosen_key = cheapest[0];
+            }
+        }
+
+        plan.routes[chosen_vehicle] = add_delivery(problem, plan.routes[chosen_vehicle], shapes[chosen_vehicle],
+                                                   chosen, chosen_insertion);
+        shapes[chosen_vehicle] = route_shape(plan.routes[chosen_vehicle]);
+        inserted[chosen] = 1;
+    }
+    plan.update_times();
+    return plan;
+}
+
+bool improve_relocate (const CourierProblem& problem, FleetPlan& plan, const FleetOptions& fleet,
+                       std::chrono::steady_clock::time_point deadline)
+{
+    int num_vehicles = plan.routes.size();
+    std::vector<RouteShape> shapes(num_vehicles);
+    for (int vehicle = 0; vehicle < num_vehicles; vehicle++)
+    {
+        shapes[vehicle] = route_shape(plan.routes[vehicle]);
+    }
+
+    for (int from = 0; from < num_vehicles; from++)
+    {
+        for (int stop : plan.routes[from].stops)
+        {
+            if (!is_pickup_stop(stop))
+            {
+                continue;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            int delivery = stop / 2;
+            CourierTour shorter = remove_delivery(plan.routes[from], delivery);
+            for (int to = 0; to < num_vehicles; to++)
+            {
+                if (to == from)
+                {
+                    continue;
+                }
+                Insertion insertion = best_insertion(problem, shapes[to].points, shapes[to].loads, fleet.capacity, delivery, 1,
+                                                     plan.routes[to].depot);
+                if (insertion.cost == NO_INSERTION)
+                {
+                    continue;
+                }
+                double to_time = plan.routes[to].total_time + insertion.cost;
+                double total_time = plan.total_time - plan.routes[from].total_time - plan.routes[to].total_time
+                                  + shorter.total_time + to_time;
+                double makespan = std::max(shorter.total_time, to_time);
+                for (int other = 0; other < num_vehicles; other++)
+                {
+                    if (other != from && other != to)
+                    {
+                        makespan = std::max(makespan, plan.routes[other].total_time);
+                    }
+                }
+                if (better_plan(total_time, makespan, plan.total_time, plan.makespan, fleet.objective))
+                {
+                    plan.routes[to] = add_delivery(problem, plan.routes[to], shapes[to], delivery, insertion);
+                    plan.routes[from] = std::move(shorter);
+                    plan.update_times();
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool improve_exchange (const CourierProblem& problem, FleetPlan& plan, const FleetOptions& fleet,
+                       std::chrono::steady_clock::time_point deadline)
+{
+    // Each route without each of its deliveries
+    int num_vehicles = plan.routes.size();
+    std::vector<std::vector<int>> deliveries(num_vehicles);
+    std::vector<std::vector<CourierTour>> shorter(num_vehicles);
+    std::vector<std::vector<RouteShape>> shorter_shapes(num_vehicles);
+    for (int vehicle = 0; vehicle < num_vehicles; vehicle++)
+    {
+        for (int stop : plan.routes[vehicle].stops)
+        {
+            if (is_pickup_stop(stop))
+            {
+                deliveries[vehicle].push_back(stop / 2);
+                shorter[vehicle].push_back(remove_delivery(plan.routes[vehicle], stop / 2));
+                shorter_shapes[vehicle].push_back(route_shape(shorter[vehicle].back()));
+            }
+        }
+    }
+
+    for (int first = 0; first < num_vehicles; first++)
+    {
+        for (int second = first + 1; second < num_vehicles; second++)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            double others_makespan = 0;
+            for (int other = 0; other < num_vehicles; other++)
+            {
+                if (other != first && other != second)
+                {
+                    others_makespan = std::max(others_makespan, plan.routes[other].total_time);
+                }
+            }
+            for (int i = 0; i < deliveries[first].size(); i++)
+            {
+                for (int j = 0; j < deliveries[second].size(); j++)
+                {
+                    // deliveries[first][i] moves to the second route, deliveries[second][j] to the first one
+                    Insertion into_first = best_insertion(problem, shorter_shapes[first][i].points, shorter_shapes[first][i].loads,
+                                                          fleet.capacity, deliveries[second][j], 1, plan.routes[first].depot);
+                    Insertion into_second = best_insertion(problem, shorter_shapes[second][j].points, shorter_shapes[second][j].loads,
+                                                           fleet.capacity, deliveries[first][i], 1, plan.routes[second].depot);
+                    if (into_first.cost == NO_INSERTION || into_second.cost == NO_INSERTION)
+                    {
+                        continue;
+                    }
+                    double first_time = shorter[first][i].total_time + into_first.cost;
+                    double second_time = shorter[second][j].total_time + into_second.cost;
+                    double total_time = plan.total_time - plan.routes[first].total_time - plan.routes[second].total_time
+                                      + first_time + second_time;
+                    double makespan = std::max({others_makespan, first_time, second_time});
+                    if (better_plan(total_time, makespan, plan.total_time, plan.makespan, fleet.objective))
+                    {
+                        plan.routes[first] = add_delivery(problem, shorter[first][i], shorter_shapes[first][i],
+                                                          deliveries[second][j], into_first);
+                        plan.routes[second] = add_delivery(problem, shorter[second][j], shorter_shapes[second][j],
+                                                           deliveries[first][i], into_second);
+                        plan.update_times();
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+std::vector<int> vehicle_depot_points (const CourierProblem& problem, const std::vector<IntersectionIdx>& depots,
+                                       const FleetOptions& fleet)
+{
+    int num_vehicles = std::max(1, fleet.num_vehicles);
+    if (depots.empty() || (!fleet.vehicle_depots.empty() && fleet.vehicle_depots.size() != num_vehicles))
+    {
+        return {};
+    }
+    std::vector<int> depot_points(num_vehicles);
+    for (int vehicle = 0; vehicle < num_vehicles; vehicle++)
+    {
+        IntersectionIdx depot = fleet.vehicle_depots.empty() ? depots[vehicle % depots.size()] : fleet.vehicle_depots[vehicle];
+        if (std::find(depots.begin(), depots.end(), depot) == depots.end())
+        {
+            return {};
+        }
+        depot_points[vehicle] = std::find(problem.points.begin(), problem.points.end(), depot) - problem.points.begin();
+    }
+    return depot_points;
+}
+
+bool better_plan (double total_a, double makespan_a, double total_b, double makespan_b, FleetObjective objective)
+{
+    double primary_a = objective == FleetObjective::MAKESPAN ? makespan_a : total_a;
+    double primary_b = objective == FleetObjective::MAKESPAN ? makespan_b : total_b;
+    double secondary_a = objective == FleetObjective::MAKESPAN ? total_a : makespan_a;
+    double secondary_b = objective == FleetObjective::MAKESPAN ? total_b : makespan_b;
+    if (primary_a < primary_b - IMPROVEMENT_EPSILON)
+    {
+        return true;
+    }
+    return primary_a <= primary_b + IMPROVEMENT_EPSILON && secondary_a < secondary_b - IMPROVEMENT_EPSILON;
+}
+
+RouteShape route_shape (const CourierTour& route)
+{
+    RouteShape shape;
+    shape.loads = route.load;
+    for (int pos = 0; pos < route.size(); pos++)
+    {
+        shape.points.push_back(route.point(pos));
+    }
+    return shape;
+}
+
+CourierTour remove_delivery (const CourierTour& route, int delivery)
+{
+    std::vector<int> stops;
+    for (int stop : route.stops)
+    {
+        if (stop / 2 != delivery)
+        {
+            stops.push_back(stop);
+        }
+    }
+    CourierTour shorter;
+    shorter.assign(*route.problem, stops, route.depot);
+    return shorter;
+}
+
+CourierTour add_delivery (const CourierProblem& problem, const CourierTour& route, const RouteShape& shape,
+                          int delivery, const Insertion& insertion)
+{
+    std::vector<int> stops = route.stops;
+    std::vector<int> points = shape.points;
+    insert_delivery(problem, delivery, insertion, stops, points);
+    CourierTour longer;
+    longer.assign(problem, stops, route.depot);
+    return longer;
+}
@@ -0,0 +1,52 @@
+/************************************************************
+ * COURIER FLEET (multi-vehicle pickUp and delivery)
+ *
+ * Deliveries are split across K vehicles. Each vehicle is based at
+ * one of the depots (given, or assigned in turn) and its route is a
+ * CourierTour that starts and ends there, so every route is charged
+ * the legs from / to its own depot, and all vehicles share the
+ * courier travel time matrix and move evaluation. An optional
+ * capacity bounds the packages a vehicle carries at once.
+ *
+ * Construction: regret insertion over the vehicles (a delivery that
+ * fits well in only one route goes first), several variants in
+ * parallel, the best plan is kept.
+ * Improvement: local search inside each route (in parallel), then
+ * relocating a delivery to another route and exchanging deliveries
+ * between two routes, until no move improves the plan or the time
+ * budget runs out.
+ ************************************************************/
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "courier/courier_solver.hpp"
+
+enum class FleetObjective
+{
+    TOTAL_TIME,     // Sum of the travel times of all vehicles
+    MAKESPAN        // Travel time of the slowest vehicle (ties: total time)
+};
+
+struct FleetOptions
+{
+    int num_vehicles = 1;
+    int capacity = 0;               // Packages a vehicle can carry at once (0: unlimited)
+    FleetObjective objective = FleetObjective::TOTAL_TIME;
+    // Index: vehicle, Value: depot (one of depots) the vehicle starts from and returns to
+    // Empty: vehicle v is based at depots[v % depots.size()] (several vehicles may share a depot)
+    std::vector<IntersectionIdx> vehicle_depots;
+};
+
+// One route per vehicle (empty if the vehicle is not used), in the format of travelingCourier,
+// each one from and back to the depot of its vehicle.
+// Uses options.time_budget, seed, num_threads and population_size (number of constructions).
+// Empty if the deliveries cannot all be served, or if vehicle_depots is not empty and does not give
+// one of the depots to each vehicle
+std::vector<std::vector<CourierSubPath>> travelingCouriers (const std::vector<DeliveryInf>& deliveries,
+                                                           const std::vector<IntersectionIdx>& depots,
+                                                           const float turn_penalty,
+                                                           const FleetOptions& fleet,
+                                                           const CourierOptions& options = CourierOptions());
+
+#endif /* FLEET_H */
@@ -0,0 +1,243 @@
+#include "courier/insertion.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <omp.h>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+// Added travel time of visiting first ... last (entering at first, leaving from last) in gap of the tour of points
+// Legs from / to the depots are those of CourierTour: the given depot, or closest depot to the first / last point
+double gap_cost (const CourierProblem& problem, const std::vector<int>& route_points, int depot, int gap, int first, int last);
+
+// Matrix travel time as a double, infinity if no path
+double leg_cost (float cost);
+
+/*******************************************************************************************************************************
+ * CONSTRUCTION
+ ********************************************************************************************************************************/
+std::vector<int> regret_insertion (const CourierProblem& problem, int first_delivery, int regret_k)
+{
+    std::vector<int> stops = {pickup_stop(first_delivery), dropoff_stop(first_delivery)};
+    std::vector<int> route_points = {problem.pick_point[first_delivery], problem.drop_point[first_delivery]};
+    std::vector<char> inserted(problem.num_deliveries, 0);
+    inserted[first_delivery] = 1;
+
+    for (int step = 1; step < problem.num_deliveries; step++)
+    {
+        // Largest regret first, then cheapest (ties: lowest delivery)
+        int chosen = -1;
+        Insertion chosen_insertion;
+        for (int delivery = 0; delivery < problem.num_deliveries; delivery++)
+        {
+            if (inserted[delivery])
+            {
+                continue;
+            }
+            Insertion insertion = best_insertion(problem, route_points, {}, 0, delivery, regret_k);
+            if (insertion.cost == NO_INSERTION)
+            {
+                return {};
+            }
+            if (chosen == -1 || insertion.regret > chosen_insertion.regret
+                || (insertion.regret == chosen_insertion.regret && insertion.cost < chosen_insertion.cost))
+            {
+                chosen = delivery;
+                chosen_insertion = insertion;
+            }
+        }
+
+        insert_delivery(problem, chosen, chosen_insertion, stops, route_points);
+        inserted[chosen] = 1;
+    }
+    return stops;
+}
+
+std::vector<CourierTour> construct_population (const CourierProblem& problem,
+                                               int population_size,
+                                               unsigned seed,
+                                               int num_threads,
+                                               std::chrono::steady_clock::time_point deadline)
+{
+    std::vector<CourierTour> population;
+    int num_deliveries = problem.num_deliveries;
+    if (num_deliveries == 0)
+    {
+        return population;
+    }
+    population_size = std::max(1, std::min(population_size, num_deliveries * MAX_REGRET_K));
+
+    // Construction s starts from the (s % num_deliveries)-th first delivery drawn, regret-2 first
+    std::vector<int> first_deliveries(num_deliveries);
+    std::iota(first_deliveries.begin(), first_deliveries.end(), 0);
+    std::mt19937 rng(seed);
+    std::shuffle(first_deliveries.begin(), first_deliveries.end(), rng);
+
+    std::vector<std::vector<int>> constructed(population_size);
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads > 0 ? num_threads : omp_get_max_threads())
+    for (int construction = 0; construction < population_size; construction++)
+    {
+        if (construction > 0 && std::chrono::steady_clock::now() >= deadline)
+        {
+            continue;
+        }
+        int regret_k = 1 + (construction + construction / num_deliveries + 1) % MAX_REGRET_K;
+        constructed[construction] = regret_insertion(problem, first_deliveries[construction % num_deliveries], regret_k);
+    }
+
+    // Distinct legal tours (the first legs may still miss a path), best first (ties: first construction)
+    for (const std::vector<int>& stops : constructed)
+    {
+        if (!stops.empty())
+        {
+            population.emplace_back();
+            population.back().assign(problem, stops);
+            if (population.back().total_time >= FLT_MAX)
+            {
+                population.pop_back();
+            }
+        }
+    }
+    std::stable_sort(population.begin(), population.end(), [](const CourierTour& a, const CourierTour& b)
+    {
+        return a.total_time < b.total_time;
+    });
+    population.erase(std::unique(population.begin(), population.end(), [](const CourierTour& a, const CourierTour& b)
+    {
+        return a.stops == b.stops;
+    }), population.end());
+    return population;
+}
+
+/*******************************************************************************************************************************
+ * INSERTION
+ ********************************************************************************************************************************/
+Insertion best_insertion (const CourierProblem& problem,
+                          const std::vector<int>& route_points,
+                          const std::vector<int>& loads,
+                          int capacity,
+                          int delivery,
+                          int regret_k,
+                          int depot)
+{
+    int pickup = problem.pick_point[delivery];
+    int dropoff = problem.drop_point[delivery];
+    int m = route_points.size();
+    Insertion best;
+
+    // k cheapest places over the dropOff gaps (each with its best pickUp gap)
+    double cheapest[MAX_REGRET_K];
+    std::fill(cheapest, cheapest + MAX_REGRET_K, NO_INSERTION);
+
+    // Cheapest pickUp gap strictly before the current dropOff gap
+    double best_pickup_cost = NO_INSERTION;
+    int best_pickup_gap = -1;
+    double pickup_to_dropoff = leg_cost(problem.cost(pickup, dropoff));
+    for (int gap = 0; gap <= m; gap++)
+    {
+        // Packages carried when reaching the gap: no pickUp can be added before a full stretch of the tour
+        bool full = capacity > 0 && gap > 0 && loads[gap - 1] >= capacity;
+        if (full)
+        {
+            best_pickup_cost = NO_INSERTION;
+            best_pickup_gap = -1;
+        }
+        double cost = best_pickup_cost + gap_cost(problem, route_points, depot, gap, dropoff, dropoff);
+        int pickup_gap = best_pickup_gap;
+        double together = full ? NO_INSERTION : gap_cost(problem, route_points, depot, gap, pickup, dropoff) + pickup_to_dropoff;
+        if (together < cost)
+        {
+            cost = together;
+            pickup_gap = gap;
+        }
+        if (cost < best.cost)
+        {
+            best.cost = cost;
+            best.pickup_gap = pickup_gap;
+            best.dropoff_gap = gap;
+        }
+        for (int rank = 0; rank < regret_k && cost < NO_INSERTION; rank++)
+        {
+            if (cost < cheapest[rank])
+            {
+                std::swap(cost, cheapest[rank]);
+            }
+        }
+
+        double pickup_cost = full ? NO_INSERTION : gap_cost(problem, route_points, depot, gap, pickup, pickup);
+        if (pickup_cost < best_pickup_cost)
+        {
+            best_pickup_cost = pickup_cost;
+            best_pickup_gap = gap;
+        }
+    }
+
+    // Regret-1: cheapest first. Fewer than k places: infinite regret (insert before losing them)
+    if (regret_k == 1)
+    {
+        best.regret = -best.cost;
+    } else
+    {
+        for (int rank = 1; rank < regret_k; rank++)
+        {
+            best.regret += cheapest[rank] - cheapest[0];
+        }
+    }
+    return best;
+}
+
+void insert_delivery (const CourierProblem& problem,
+                      int delivery,
+                      const Insertion& insertion,
+                      std::vector<int>& stops,
+                      std::vector<int>& route_points)
+{
+    // DropOff first, so that the pickUp gap does not move
+    int pickup = problem.pick_point[delivery];
+    int dropoff = problem.drop_point[delivery];
+    if (insertion.pickup_gap == insertion.dropoff_gap)
+    {
+        int gap = insertion.pickup_gap;
+        stops.insert(stops.begin() + gap, {pickup_stop(delivery), dropoff_stop(delivery)});
+        route_points.insert(route_points.begin() + gap, {pickup, dropoff});
+    } else
+    {
+        stops.insert(stops.begin() + insertion.dropoff_gap, dropoff_stop(delivery));
+        route_points.insert(route_points.begin() + insertion.dropoff_gap, dropoff);
+        stops.insert(stops.begin() + insertion.pickup_gap, pickup_stop(delivery));
+        route_points.insert(route_points.begin() + insertion.pickup_gap, pickup);
+    }
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+double gap_cost (const CourierProblem& problem, const std::vector<int>& route_points, int depot, int gap, int first, int last)
+{
+    auto start_cost = [&](int point)
+    {
+        return leg_cost(depot == -1 ? problem.start_cost(point) : problem.cost(depot, point));
+    };
+    auto end_cost = [&](int point)
+    {
+        return leg_cost(depot == -1 ? problem.end_cost(point) : problem.cost(point, depot));
+    };
+    int m = route_points.size();
+    if (m == 0)
+    {
+        return start_cost(first) + end_cost(last);
+    }
+    double enter = gap == 0 ? start_cost(first) : leg_cost(problem.cost(route_points[gap - 1], first));
+    double leave = gap == m ? end_cost(last) : leg_cost(problem.cost(last, route_points[gap]));
+    double removed = gap == 0 ? start_cost(route_points[0])
+                   : gap == m ? end_cost(route_points[m - 1])
+                   : leg_cost(problem.cost(route_points[gap - 1], route_points[gap]));
+    return enter + leave - removed;
+}
+
+double leg_cost (float cost)
+{
+    return cost == FLT_MAX ? NO_INSERTION : cost;
+}
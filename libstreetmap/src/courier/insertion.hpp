@@ -0,0 +1,72 @@
+/************************************************************
+ * COURIER INSERTION CONSTRUCTION
+ *
+ * Builds tours by inserting whole deliveries (pickUp and dropOff
+ * together, pickUp first) into a growing tour, using the dense
+ * travel time matrix. At each step the delivery with the largest
+ * regret is inserted at its cheapest place: regret-k is the extra
+ * cost of its 2nd..k-th best dropOff places over the best one, so
+ * deliveries that are about to lose their good places go first.
+ * Regret-1 is plain cheapest insertion.
+ *
+ * Many constructions (different first deliveries and k) run in
+ * parallel and all of them are kept, as the starting population
+ * of the improvement phase.
+ ************************************************************/
+
+#ifndef INSERTION_H
+#define INSERTION_H
+
+#include <chrono>
+#include <limits>
+#include "courier/courier_tour.hpp"
+
+// Constructions use regret-1 (cheapest insertion) up to regret-MAX_REGRET_K
+const int MAX_REGRET_K = 3;
+
+// Cost of insertions that need a missing path
+const double NO_INSERTION = std::numeric_limits<double>::infinity();
+
+// Best place of one delivery in a tour of points
+// Gap g of a tour of m points is between positions g - 1 and g (0: before the first point, m: after the last one)
+struct Insertion
+{
+    int pickup_gap = -1;
+    int dropoff_gap = -1;           // Equal to pickup_gap: dropOff right after the pickUp
+    double cost = NO_INSERTION;     // Added travel time, depot legs included
+    double regret = 0;              // Regret-k value over the dropOff gaps (regret-1: -cost)
+};
+
+// Cheapest place of a delivery in the tour of points, in O(number of points)
+// capacity > 0: loads[k] is the number of packages carried when leaving point k, the delivery is
+// only placed where it never makes the load go over capacity
+// depot: point the tour starts and ends at (-1: closest depots, see CourierTour)
+Insertion best_insertion (const CourierProblem& problem,
+                          const std::vector<int>& route_points,
+                          const std::vector<int>& loads,
+                          int capacity,
+                          int delivery,
+                          int regret_k,
+                          int depot = -1);
+
+// Insert the stops and points of a delivery where best_insertion placed it
+void insert_delivery (const CourierProblem& problem,
+                      int delivery,
+                      const Insertion& insertion,
+                      std::vector<int>& stops,
+                      std::vector<int>& route_points);
+
+// Stops of a tour built by regret-k insertion, starting from first_delivery alone
+// Empty if some delivery cannot be inserted (no path to / from it)
+std::vector<int> regret_insertion (const CourierProblem& problem, int first_delivery, int regret_k);
+
+// Run up to population_size constructions in parallel (first deliveries drawn from seed, k cycling
+// through 1..MAX_REGRET_K), returns the distinct tours found, best first. After the deadline only
+// the first construction is still run. Empty if no legal tour was found
+std::vector<CourierTour> construct_population (const CourierProblem& problem,
+                                               int population_size,
+                                               unsigned seed,
+                                               int num_threads,
+                                               std::chrono::steady_clock::time_point deadline);
+
+#endif /* INSERTION_H */
@@ -0,0 +1,140 @@
+#include "courier/local_search.hpp"
+#include <functional>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+// Statistics of the last local search made by each thread
+thread_local LocalSearchStats local_search_stats;
+
+// The clock is only read every this many evaluated moves
+const int DEADLINE_CHECK_INTERVAL = 1024;
+
+// One pass over a neighbourhood: apply the first improving move found
+// Returns true if a move was applied, sets out_of_time once the deadline has passed
+bool improve_two_opt (CourierTour& tour, int capacity, LocalSearchStats& stats,
+                      std::chrono::steady_clock::time_point deadline, bool& out_of_time);
+bool improve_or_opt (CourierTour& tour, int length, int capacity, LocalSearchStats& stats,
+                     std::chrono::steady_clock::time_point deadline, bool& out_of_time);
+
+// Apply a move unless it makes the load go over capacity (0: unlimited), returns true if applied
+bool apply_within_capacity (CourierTour& tour, int capacity, const std::function<void (CourierTour&)>& apply_move);
+
+// Count one evaluated move, and check the deadline every DEADLINE_CHECK_INTERVAL moves
+bool count_move (LocalSearchStats& stats, std::chrono::steady_clock::time_point deadline, bool& out_of_time);
+
+/*******************************************************************************************************************************
+ * LOCAL SEARCH
+ ********************************************************************************************************************************/
+LocalSearchStats local_search (CourierTour& tour, std::chrono::steady_clock::time_point deadline, int capacity)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    LocalSearchStats stats;
+    stats.initial_time = tour.total_time;
+
+    // Cheapest neighbourhoods first; start over from 2-opt whenever one of them improves the tour
+    bool out_of_time = false;
+    while (!out_of_time)
+    {
+        bool improved = improve_two_opt(tour, capacity, stats, deadline, out_of_time);
+        for (int length = 1; !improved && !out_of_time && length <= OR_OPT_MAX_LENGTH; length++)
+        {
+            improved = improve_or_opt(tour, length, capacity, stats, deadline, out_of_time);
+        }
+        if (!improved && !out_of_time)
+        {
+            stats.local_optimum = true;
+            break;
+        }
+    }
+
+    stats.final_time = tour.total_time;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    local_search_stats = stats;
+    return stats;
+}
+
+const LocalSearchStats& last_local_search_stats ()
+{
+    return local_search_stats;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+bool improve_two_opt (CourierTour& tour, int capacity, LocalSearchStats& stats,
+                      std::chrono::steady_clock::time_point deadline, bool& out_of_time)
+{
+    int n = tour.size();
+    for (int i = 0; i < n && !out_of_time; i++)
+    {
+        for (int j = i + 1; j < n; j++)
+        {
+            if (!count_move(stats, deadline, out_of_time))
+            {
+                return false;
+            }
+            if (tour.two_opt_delta(i, j) < -IMPROVEMENT_EPSILON
+                && apply_within_capacity(tour, capacity, [&](CourierTour& moved) { moved.apply_two_opt(i, j); }))
+            {
+                stats.moves_applied++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool improve_or_opt (CourierTour& tour, int length, int capacity, LocalSearchStats& stats,
+                     std::chrono::steady_clock::time_point deadline, bool& out_of_time)
+{
+    int n = tour.size();
+    for (int first = 0; first + length <= n && !out_of_time; first++)
+    {
+        for (int after = -1; after < n; after++)
+        {
+            if (after >= first - 1 && after < first + length)
+            {
+                continue;
+            }
+            if (!count_move(stats, deadline, out_of_time))
+            {
+                return false;
+            }
+            if (tour.or_opt_delta(first, length, after) < -IMPROVEMENT_EPSILON
+                && apply_within_capacity(tour, capacity, [&](CourierTour& moved) { moved.apply_or_opt(first, length, after); }))
+            {
+                stats.moves_applied++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool apply_within_capacity (CourierTour& tour, int capacity, const std::function<void (CourierTour&)>& apply_move)
+{
+    if (capacity <= 0)
+    {
+        apply_move(tour);
+        return true;
+    }
+    CourierTour moved = tour;
+    apply_move(moved);
+    if (moved.max_load() > capacity)
+    {
+        return false;
+    }
+    tour = std::move(moved);
+    return true;
+}
+
+bool count_move (LocalSearchStats& stats, std::chrono::steady_clock::time_point deadline, bool& out_of_time)
+{
+    stats.moves_evaluated++;
+    if (stats.moves_evaluated % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+    {
+        out_of_time = true;
+    }
+    return !out_of_time;
+}
@@ -0,0 +1,49 @@
+/************************************************************
+ * COURIER LOCAL SEARCH
+ *
+ * Descent over the 2-opt, Or-opt (segments of 2 to 3 stops) and
+ * relocate (single stop) neighbourhoods of a CourierTour: the first
+ * improving legal move found is applied, until no move improves
+ * the tour or the wall-clock budget runs out.
+ ************************************************************/
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <chrono>
+#include "courier/courier_tour.hpp"
+
+// Smallest decrease in travel time accepted as an improvement (ignores float rounding)
+const double IMPROVEMENT_EPSILON = 1e-6;
+
+// Longest segment moved by Or-opt
+const int OR_OPT_MAX_LENGTH = 3;
+
+struct LocalSearchStats
+{
+    long long moves_evaluated = 0;
+    int moves_applied = 0;
+    double seconds = 0;
+    double initial_time = 0;        // Travel time of the seed tour
+    double final_time = 0;
+    bool local_optimum = false;     // false if the budget ran out first
+
+    double moves_per_second () const
+    {
+        return seconds > 0 ? moves_evaluated / seconds : 0;
+    }
+    // Relative improvement over the seed tour (0.05: 5% shorter)
+    double improvement () const
+    {
+        return initial_time > 0 ? (initial_time - final_time) / initial_time : 0;
+    }
+};
+
+// Improve the tour in place until a local optimum or the deadline
+// capacity > 0: only moves that never carry more than capacity packages at once are applied
+LocalSearchStats local_search (CourierTour& tour, std::chrono::steady_clock::time_point deadline, int capacity = 0);
+
+// Statistics of the last local search run by the calling thread
+const LocalSearchStats& last_local_search_stats ();
+
+#endif /* LOCAL_SEARCH_H */
@@ -4,7 +4,7 @@
 // Draw street segments
 *************************************************************/
 // Draw street segments with pixels (for far zoom levels)
-void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path)
+void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path)
 {
     // Set colors according to street type
     if (on_path)
@@ -18,7 +18,8 @@ void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentDetailedInfo& se
         }
         // Set line width based on current zoom level and street type
         g->set_line_width(5);
-    } else if (segment.highway_type == "motorway" || segment.highway_type == "motorway_link")
+    } else if (Street_Segments.highway_type[segment] == HIGHWAY_MOTORWAY
+               || Street_Segments.highway_type[segment] == HIGHWAY_MOTORWAY_LINK)
     {
         if (!night_mode)
         {
@@ -28,7 +29,7 @@ void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentDetailedInfo& se
             g->set_color(58, 128, 181);
         }
         // Set line width based on current zoom level and street type
-        g->set_line_width(get_street_width_pixel(segment.highway_type));
+        g->set_line_width(get_street_width_pixel(Street_Segments.highway_type[segment]));
     } else 
     {
         if (!night_mode)
@@ -39,29 +40,29 @@ void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentDetailedInfo& se
             g->set_color(96, 96, 96);
         }
         // Set line width based on current zoom level and street type
-        g->set_line_width(get_street_width_pixel(segment.highway_type));
+        g->set_line_width(get_street_width_pixel(Street_Segments.highway_type[segment]));
     }
 
     // Round street ends
     g->set_line_cap(ezgl::line_cap(1));
     // Draw street segments including curvepoints
-    ezgl::point2d from_xy = segment.from_xy;
+    ezgl::point2d from_xy = Street_Segments.from_xy[segment];
     ezgl::point2d curve_pt_xy; // Temp xy for current curve point.
                                // Starts drawing at from_xy to first curve point.
     
     // Connecting curvepoints. Increment from_xy.
-    for (int i = 0; i < segment.numCurvePoints; i++)
+    for (const ezgl::point2d& curve_point : Street_Segments.curve_points_xy[segment])
     {
-        curve_pt_xy = segment.curvePoints_xy[i];
+        curve_pt_xy = curve_point;
         g->draw_line(from_xy, curve_pt_xy);
         from_xy = curve_pt_xy;
     }
     // Connect last curve point to (x_to, y_to)
-    g->draw_line(from_xy, segment.to_xy);
+    g->draw_line(from_xy, Street_Segments.to_xy[segment]);
 }
 
 // Draw street segments with meters (for close zoom levels)
-void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path)
+void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path)
 {
     // Set colors according to street type
     if (on_path)
@@ -73,7 +74,8 @@ void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentDetailedInfo& s
         {
             g->set_color(ezgl::RED);
         }
-    } else if (segment.highway_type == "motorway" || segment.highway_type == "motorway_link")
+    } else if (Street_Segments.highway_type[segment] == HIGHWAY_MOTORWAY
+               || Street_Segments.highway_type[segment] == HIGHWAY_MOTORWAY_LINK)
     {
         if (!night_mode)
         {
@@ -94,129 +96,101 @@ void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentDetailedInfo& s
     }
 
     // Draw street segments including curvepoints
-    ezgl::point2d from_xy = segment.from_xy;
+    ezgl::point2d from_xy = Street_Segments.from_xy[segment];
     ezgl::point2d curve_pt_xy; // Temp xy for current curve point.
                                // Starts drawing at from_xy to first curve point.
+    int width = Street_Segments.width[segment];
+    const GeometryRange& curve_points_xy = Street_Segments.curve_points_xy[segment];
+    const ezgl::point2d* poly_points = Street_Segments.poly_points[segment].begin();
+    int num_polygons = Street_Segments.poly_points[segment].size() / POLY_CORNERS;
+    // fill_poly takes a vector: the corners of each polygon are copied into one that is reused across calls
+    static std::vector<ezgl::point2d> polygon;
     // Circle around "from" intersection
-    g->fill_arc(from_xy, segment.width, 0, 360);
+    g->fill_arc(from_xy, width, 0, 360);
     // Drawing circles around curvepoints and polygons leading to THAT curvepoint
-    for (int i = 0; i < segment.poly_points.size() - 1; i++)
+    for (int i = 0; i < num_polygons - 1; i++)
     {
-        g->fill_arc(segment.curvePoints_xy[i], segment.width, 0, 360);
-        g->fill_poly(segment.poly_points[i]);
+        g->fill_arc(curve_points_xy[i], width, 0, 360);
+        polygon.assign(poly_points + i * POLY_CORNERS, poly_points + (i + 1) * POLY_CORNERS);
+        g->fill_poly(polygon);
     }
     // Draw last segment in poly_points
-    g->fill_poly(segment.poly_points[segment.poly_points.size() - 1]);
+    polygon.assign(poly_points + (num_polygons - 1) * POLY_CORNERS, poly_points + num_polygons * POLY_CORNERS);
+    g->fill_poly(polygon);
     // Circle around "to" intersection
-    g->fill_arc(segment.to_xy, segment.width, 0, 360);
+    g->fill_arc(Street_Segments.to_xy[segment], width, 0, 360);
 }
 
-// Manually fix street width with pixels according to zoom levels (far zoom levels)
-int get_street_width_pixel (std::string& street_type)
+/************************************************************
+// Street types and zoom levels
+*************************************************************/
+// Columns: motorway, motorway_link, trunk, primary, secondary, tertiary, unclassified, residential, path, other
+// Zoom levels 0 to 2 draw the main streets with pixels, 3 and 4 draw streets with meters
+const SegmentDrawMode SEGMENT_DRAW_MODE[NUM_ZOOM_LEVELS][NUM_HIGHWAY_TYPES] = {
+    {SEGMENT_PIXELS, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_PIXELS, SEGMENT_HIDDEN,
+     SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN},
+    {SEGMENT_PIXELS, SEGMENT_HIDDEN, SEGMENT_PIXELS, SEGMENT_PIXELS, SEGMENT_PIXELS,
+     SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN},
+    {SEGMENT_PIXELS, SEGMENT_HIDDEN, SEGMENT_PIXELS, SEGMENT_PIXELS, SEGMENT_PIXELS,
+     SEGMENT_PIXELS, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN, SEGMENT_HIDDEN},
+    {SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS,
+     SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_HIDDEN, SEGMENT_HIDDEN},
+    {SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS,
+     SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS, SEGMENT_METERS}
+};
+
+// Manually fixed street width with pixels according to zoom levels (far zoom levels)
+// Path segments (and the found path) are always 5 pixels wide
+const int STREET_WIDTH_PIXELS[NUM_ZOOM_LEVELS][NUM_HIGHWAY_TYPES] = {
+    {4, 2, 2, 2, 2, 2, 2, 2, 5, 2},
+    {5, 0, 0, 3, 0, 0, 0, 0, 5, 0},
+    {5, 5, 3, 5, 2, 2, 0, 0, 5, 0},
+    {5, 5, 5, 5, 5, 5, 5, 5, 5, 5},
+    {5, 5, 5, 5, 5, 5, 5, 5, 5, 5}
+};
+
+// Manually fixed street width with meters (close zoom levels)
+const int STREET_WIDTH_METERS[NUM_HIGHWAY_TYPES] = {5, 5, 4, 5, 4, 3, 3, 3, 5, 1};
+
+int street_zoom_level ()
 {
-    // If the segment is part of path
-    if (street_type == "path")
+    if (curr_world_width >= ZOOM_LIMIT_0)
     {
-        return 5;
-    }
-    // Else, determine width based on street type and zoom levels
-    if (curr_world_width > ZOOM_LIMIT_0)
-    {
-        if (street_type == "motorway") 
-        {
-            return 4;
-        } else
-        {
-            return 2;
-        }
-    } else if (ZOOM_LIMIT_1 < curr_world_width && curr_world_width < ZOOM_LIMIT_0)
+        return 0;
+    } else if (curr_world_width >= ZOOM_LIMIT_1)
     {
-        if (street_type == "motorway")
-        {
-            return 5;
-        } else if (street_type == "primary")
-        {
-            return 3;
-        } else if (street_type == "trunk")
-        {
-            return 0;
-        } else if (street_type == "secondary") 
-        {
-            return 0;
-        }
-    } else if (ZOOM_LIMIT_2 < curr_world_width && curr_world_width < ZOOM_LIMIT_1)
+        return 1;
+    } else if (curr_world_width >= ZOOM_LIMIT_2)
     {
-        if (street_type == "motorway") 
-        {
-            return 5;
-        } else if (street_type == "motorway_link") 
-        {
-            return 5;
-        } else if (street_type == "primary")
-        {
-            return 5;
-        } else if (street_type == "trunk") 
-        {
-            return 3;
-        } else if (street_type == "secondary") 
-        {
-            return 2;
-        } else if (street_type == "tertiary") 
-        {
-            return 2;
-        }
-    } else if (curr_world_width <= ZOOM_LIMIT_2)
+        return 2;
+    } else if (curr_world_width >= ZOOM_LIMIT_3)
     {
-        return 5;
+        return 3;
     }
-    return 0;
+    return 4;
 }
 
-// Manually fix street width with meters according to zoom levels (close zoom levels)
-int get_street_width_meters (std::string& street_type)
+int get_street_width_pixel (HighwayType street_type)
 {
-    if (street_type == "motorway") 
-    {
-        return 5;
-    } else if (street_type == "motorway_link") 
-    {
-        return 5;
-    } else if (street_type == "primary") 
-    {
-        return 5;
-    } else if (street_type == "trunk") 
-    {
-        return 4;
-    } else if (street_type == "secondary")
-    {
-        return 4;
-    } else if (street_type == "tertiary") 
-    {
-        return 3;
-    } else if (street_type == "unclassified")
-    {
-        return 3;
-    } else if (street_type == "residential") 
-    {
-        return 3;
-    } else if (street_type == "path")
-    {
-        return 5;
-    } else {
-        return 1;
-    }
-    return 0;
+    return STREET_WIDTH_PIXELS[street_zoom_level()][street_type];
+}
+
+int get_street_width_meters (HighwayType street_type)
+{
+    return STREET_WIDTH_METERS[street_type];
 }
 
 /************************************************************
 // Draw street names
 *************************************************************/
 // Draws text on street segments
-void draw_seg_name (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path)
+void draw_seg_name (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path)
 {
-    g->set_text_rotation(segment.angle_degree);
+    g->set_text_rotation(Street_Segments.angle_degree[segment]);
     // Draw name or arrow at position between from_xy and to_xy (temporary)
-    ezgl::point2d mid_xy = {(segment.from_xy.x + segment.to_xy.x) / 2, (segment.from_xy.y + segment.to_xy.y) / 2};
+    const ezgl::point2d& from_xy = Street_Segments.from_xy[segment];
+    const ezgl::point2d& to_xy = Street_Segments.to_xy[segment];
+    ezgl::point2d mid_xy = {(from_xy.x + to_xy.x) / 2, (from_xy.y + to_xy.y) / 2};
     if(!night_mode)
     {
         if (on_path)
@@ -241,11 +215,13 @@ void draw_seg_name (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool
     if (on_path)
     {
         g->set_font_size(12);
-        g->draw_text(mid_xy, segment.streetName_arrow, segment.length * 0.5, segment.width * 1.8);
+        g->draw_text(mid_xy, Street_Segments.street_name_arrow[segment], Street_Segments.length[segment] * 0.5,
+                     Street_Segments.width[segment] * 1.8);
     } else
     {
         g->set_font_size(10);
-        g->draw_text(mid_xy, segment.streetName_arrow, segment.length * 0.5, segment.width * 1.8);
+        g->draw_text(mid_xy, Street_Segments.street_name_arrow[segment], Street_Segments.length[segment] * 0.5,
+                     Street_Segments.width[segment] * 1.8);
     }
 }
 
@@ -256,7 +232,9 @@ void draw_feature_area (ezgl::renderer *g, FeatureDetailedInfo tempFeatureInfo)
 {
     //Store feature information in temp variables for checking
     FeatureType tempType = tempFeatureInfo.featureType;
-    std::vector<ezgl::point2d> tempPoints = tempFeatureInfo.featurePoints;
+    // Copied from Geometry_Points for fill_poly, into a vector reused across calls
+    static std::vector<ezgl::point2d> tempPoints;
+    tempPoints.assign(tempFeatureInfo.featurePoints.begin(), tempFeatureInfo.featurePoints.end());
     //Draw different types of features with different colors
     if (tempType == PARK)
     {
@@ -418,12 +396,11 @@ void draw_subway_lines (ezgl::renderer* g)
         }
         // Set subway line to processed color
         g->set_color((AllSubwayRoutes[route].colour));
-        for (int way = 0; way < (AllSubwayRoutes[route].track_points.size()); way++)
+        for (const GeometryRange& track_points : AllSubwayRoutes[route].track_points)
         {
-            for (int node = 0; node < AllSubwayRoutes[route].track_points[way].size() - 1; node++)
+            for (int node = 0; node < (int) track_points.size() - 1; node++)
             {
-                g->draw_line(AllSubwayRoutes[route].track_points[way][node], 
-                            AllSubwayRoutes[route].track_points[way][node + 1]);
+                g->draw_line(track_points[node], track_points[node + 1]);
             }
         }
     }
@@ -9,15 +9,31 @@
 #include "m1.h"
 #include "globals.h"
 
+// How a street segment is drawn at a zoom level
+enum SegmentDrawMode
+{
+    SEGMENT_HIDDEN,
+    SEGMENT_PIXELS,     // draw_street_segment_pixel (far zoom levels)
+    SEGMENT_METERS      // draw_street_segment_meters (close zoom levels)
+};
+// Index: zoom level, highway type
+extern const SegmentDrawMode SEGMENT_DRAW_MODE[NUM_ZOOM_LEVELS][NUM_HIGHWAY_TYPES];
+extern const int STREET_WIDTH_PIXELS[NUM_ZOOM_LEVELS][NUM_HIGHWAY_TYPES];
+// Index: highway type
+extern const int STREET_WIDTH_METERS[NUM_HIGHWAY_TYPES];
+
+// Street drawing zoom level of curr_world_width (0: farthest)
+int street_zoom_level ();
+
 void draw_feature_area (ezgl::renderer *g, FeatureDetailedInfo tempFeatureInfo);
 void draw_POIs (ezgl::renderer* g, POIDetailedInfo POI);
-void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path = false);
-void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path = false);
+void draw_street_segment_pixel (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path = false);
+void draw_street_segment_meters (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path = false);
 void draw_line_meters (ezgl::renderer *g, ezgl::point2d from_xy,
                       ezgl::point2d to_xy, int& width_meters);
-int get_street_width_pixel (std::string& street_type);
-int get_street_width_meters (std::string& street_type);
-void draw_seg_name (ezgl::renderer *g, StreetSegmentDetailedInfo& segment, bool on_path = false);
+int get_street_width_pixel (HighwayType street_type);
+int get_street_width_meters (HighwayType street_type);
+void draw_seg_name (ezgl::renderer *g, StreetSegmentIdx segment, bool on_path = false);
 
 void draw_png (ezgl::renderer* g, ezgl::point2d inter_xy, std::string pin_type);
 void draw_subway_lines (ezgl::renderer* g);
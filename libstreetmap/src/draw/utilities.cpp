@@ -50,16 +50,16 @@ void view_path (ezgl::application* application, double camera_level)
         gtk_text_buffer_set_text(DirectionTextBuffer, message, -1);
     } else
     {
-        double max_y = Segment_SegmentDetailedInfo[found_path[0]].segmentRectangle.top();
-        double min_y = Segment_SegmentDetailedInfo[found_path[0]].segmentRectangle.bottom();
-        double max_x = Segment_SegmentDetailedInfo[found_path[0]].segmentRectangle.right();
-        double min_x = Segment_SegmentDetailedInfo[found_path[0]].segmentRectangle.left();
+        double max_y = Street_Segments.bounds[found_path[0]].top();
+        double min_y = Street_Segments.bounds[found_path[0]].bottom();
+        double max_x = Street_Segments.bounds[found_path[0]].right();
+        double min_x = Street_Segments.bounds[found_path[0]].left();
         for(auto i : found_path)
         {
-            max_y = std::max(max_y, Segment_SegmentDetailedInfo[i].segmentRectangle.top());
-            min_y = std::min(min_y, Segment_SegmentDetailedInfo[i].segmentRectangle.bottom());
-            max_x = std::max(max_x, Segment_SegmentDetailedInfo[i].segmentRectangle.right());
-            min_x = std::min(min_x, Segment_SegmentDetailedInfo[i].segmentRectangle.left());
+            max_y = std::max(max_y, Street_Segments.bounds[i].top());
+            min_y = std::min(min_y, Street_Segments.bounds[i].bottom());
+            max_x = std::max(max_x, Street_Segments.bounds[i].right());
+            min_x = std::min(min_x, Street_Segments.bounds[i].left());
         }
         double new_width = std::max((max_y - min_y), (max_x - min_x));
         ezgl::point2d center = {(min_x + max_x) / 2, (max_y + min_y) / 2};
@@ -97,14 +97,14 @@ void generate_directions ()
     {
         for (StreetSegmentIdx tempIndex = 0; tempIndex < found_path.size() - 1; tempIndex++)
         {
-            StreetSegmentDetailedInfo tempSegInfo = Segment_SegmentDetailedInfo[found_path[tempIndex]];
-            StreetSegmentDetailedInfo nextTempSegInfo = Segment_SegmentDetailedInfo[found_path[tempIndex + 1]];
-            StreetIdx tempSegIdx = tempSegInfo.streetID;
-            StreetIdx nextTempSegIdx = nextTempSegInfo.streetID;
-            pointX1 = Intersection_IntersectionInfo[tempSegInfo.from].position_xy;
-            pointX2 = Intersection_IntersectionInfo[tempSegInfo.to].position_xy;
-            pointX3 = Intersection_IntersectionInfo[nextTempSegInfo.from].position_xy;
-            pointX4 = Intersection_IntersectionInfo[nextTempSegInfo.to].position_xy;
+            StreetSegmentIdx tempSeg = found_path[tempIndex];
+            StreetSegmentIdx nextTempSeg = found_path[tempIndex + 1];
+            StreetIdx tempSegIdx = Street_Segments.street[tempSeg];
+            StreetIdx nextTempSegIdx = Street_Segments.street[nextTempSeg];
+            pointX1 = Intersection_IntersectionInfo[Street_Segments.from[tempSeg]].position_xy;
+            pointX2 = Intersection_IntersectionInfo[Street_Segments.to[tempSeg]].position_xy;
+            pointX3 = Intersection_IntersectionInfo[Street_Segments.from[nextTempSeg]].position_xy;
+            pointX4 = Intersection_IntersectionInfo[Street_Segments.to[nextTempSeg]].position_xy;
             if (pointX1 == pointX3)
             {
                 pointFrom = pointX2;
@@ -74,6 +74,8 @@ const float ZOOM_LIMIT_1 = 15000;
 const float ZOOM_LIMIT_2 = 5000;
 const float ZOOM_LIMIT_3 = 2000;
 const float ZOOM_LIMIT_4 = 1500;
+// Street drawing zoom levels: 0 (curr_world_width >= ZOOM_LIMIT_0) to 4 (curr_world_width < ZOOM_LIMIT_3)
+const int NUM_ZOOM_LEVELS = 5;
 
 // Minimum area a feature must have to be displayed by different zoom levels
 const double FEATURE_AREA_LIMIT_0 = 500000;
@@ -123,35 +125,130 @@ extern int streetNum;
 extern int featureNum;
 extern int POINum;
 
+// *********************************************************************************************************
+// Map loading
+// *********************************************************************************************************
+// Wall-clock time of one stage of m1_init (in seconds, start is relative to the start of m1_init)
+struct LoadStageTiming
+{
+    std::string stage;
+    double start;
+    double seconds;
+};
+// Stages of the last m1_init, in the order they finished
+extern std::vector<LoadStageTiming> Load_Stage_Timings;
+
+// *********************************************************************************************************
+// Geometry
+// *********************************************************************************************************
+// Points of all segment, feature and subway geometry, in one contiguous array
+// Filled once per map (a few allocations in total), addressed by GeometryRange
+extern std::vector<ezgl::point2d> Geometry_Points;
+
+// A run of count points in Geometry_Points, starting at first
+// Iterates over the points in place (only valid while Geometry_Points is not resized)
+struct GeometryRange
+{
+    std::size_t first = 0;
+    std::size_t count = 0;
+
+    std::size_t size () const
+    {
+        return count;
+    }
+    const ezgl::point2d* begin () const
+    {
+        return Geometry_Points.data() + first;
+    }
+    const ezgl::point2d* end () const
+    {
+        return Geometry_Points.data() + first + count;
+    }
+    const ezgl::point2d& operator[] (std::size_t i) const
+    {
+        return Geometry_Points[first + i];
+    }
+};
+
+// Each polygon of a segment (one per piece between curve points) has 4 corners
+const int POLY_CORNERS = 4;
+
 // *********************************************************************************************************
 // Street Segments
 // ********************************************************************************************************
-// Pre-processed information of each street segment
-struct StreetSegmentDetailedInfo
+// Street type of a segment: the "highway" tag of its OSM way, interned when the ways are loaded
+// Every type not listed is HIGHWAY_OTHER
+enum HighwayType : unsigned char
+{
+    HIGHWAY_MOTORWAY,
+    HIGHWAY_MOTORWAY_LINK,
+    HIGHWAY_TRUNK,
+    HIGHWAY_PRIMARY,
+    HIGHWAY_SECONDARY,
+    HIGHWAY_TERTIARY,
+    HIGHWAY_UNCLASSIFIED,
+    HIGHWAY_RESIDENTIAL,
+    HIGHWAY_PATH,
+    HIGHWAY_OTHER,
+    NUM_HIGHWAY_TYPES
+};
+
+// Pre-processed information of all street segments, one array per field (Index: segment id)
+// Hot arrays are read by path searches and by the grid visibility tests of every frame; cold arrays
+// (names, geometry) only once a segment is actually drawn or labelled, so they never share cache lines
+struct StreetSegmentStore
 {
-    StreetSegmentIdx id;        // id of the segment
-    OSMID wayOSMID;             // OSM ID of the source way
-                                // NOTE: Multiple segments may match a single OSM way ID
-    std::string highway_type;   // Street type of street segment
-    IntersectionIdx from, to;   // Intersection ID this segment runs from/to
-    ezgl::point2d from_xy, to_xy;
-    bool oneWay;
-    double length;              // Real length (in meters) of segment
-    int width;                  // Real half-width (in meters) of segment
-    double travel_time;         // Travel time, in seconds
-    float speedLimit;           // Speed limit of current segment, in m/s
-    StreetIdx streetID;         // Index of street this segment belongs to
-    std::string streetName;     // Name of the street this segment belongs to
-    std::string streetName_arrow;   // Name of the street this segment belongs to, arrow included
-    double angle_degree;         // Angle to be rotated to draw street segment name and arrow, in degrees
-    int numCurvePoints;         // number of curve points between the ends
-    std::vector<ezgl::point2d> curvePoints_xy; // Vector of xy of all curvepoints (not containing from and to)
-    std::vector<std::vector<ezgl::point2d>> poly_points; // Each index is a vector of polygon points needed to draw 
-                                                        // small curve segments in world coordinates
-    ezgl::rectangle segmentRectangle;       // Rectangle for checking display & navigation zooming
+    // Hot fields
+    std::vector<IntersectionIdx> from, to;      // Intersection ID each segment runs from/to
+    std::vector<double> travel_time;            // Travel time, in seconds
+    std::vector<StreetIdx> street;              // Index of street each segment belongs to
+    std::vector<char> one_way;
+    std::vector<ezgl::rectangle> bounds;        // Rectangle for checking display & navigation zooming
+    std::vector<HighwayType> highway_type;      // Street type of street segment
+
+    // Cold fields
+    std::vector<OSMID> way_osmid;               // OSM ID of the source way
+                                                // NOTE: Multiple segments may match a single OSM way ID
+    std::vector<double> length;                 // Real length (in meters) of segment
+    std::vector<int> width;                     // Real half-width (in meters) of segment
+    std::vector<ezgl::point2d> from_xy, to_xy;
+    std::vector<std::string> street_name;       // Name of the street each segment belongs to
+    std::vector<std::string> street_name_arrow; // Name of the street each segment belongs to, arrow included
+    std::vector<double> angle_degree;           // Angle to be rotated to draw street segment name and arrow, in degrees
+    std::vector<GeometryRange> curve_points_xy; // xy of all curvepoints (not containing from and to)
+    std::vector<GeometryRange> poly_points;     // POLY_CORNERS corners for each polygon needed to draw
+                                                // small curve segments in world coordinates (curve points + 1 polygons)
+
+    int size () const
+    {
+        return from.size();
+    }
+    void resize (int segment_count)
+    {
+        from.resize(segment_count);
+        to.resize(segment_count);
+        travel_time.resize(segment_count);
+        street.resize(segment_count);
+        one_way.resize(segment_count);
+        bounds.resize(segment_count);
+        highway_type.resize(segment_count);
+        way_osmid.resize(segment_count);
+        length.resize(segment_count);
+        width.resize(segment_count);
+        from_xy.resize(segment_count);
+        to_xy.resize(segment_count);
+        street_name.resize(segment_count);
+        street_name_arrow.resize(segment_count);
+        angle_degree.resize(segment_count);
+        curve_points_xy.resize(segment_count);
+        poly_points.resize(segment_count);
+    }
+    void clear ()
+    {
+        *this = StreetSegmentStore();
+    }
 };
-// Index: Segment id, Value: Processed information of the segment
-extern std::vector<StreetSegmentDetailedInfo> Segment_SegmentDetailedInfo;
+extern StreetSegmentStore Street_Segments;
 
 // *******************************************************************
 // Intersections
@@ -164,11 +261,6 @@ struct IntersectionInfo
     std::string name;
     // Vector of all segments 
     std::vector<StreetSegmentIdx> all_segments;
-    // Vector of neighboring IntersectionIdx - SegmentIdx pairs
-    // Neighboring intersections are intersections that the current intersection can travel to,
-    // taking into consideration one-way street and self-connecting intersection (included)
-    // The segment ids are segments that can be taken to travel to the neighboring intersection
-    std::vector<std::pair<IntersectionIdx, std::vector<StreetSegmentIdx>>> neighbors_and_segments;
 };
 
 // Index: Intersection id, Value: Pre-processed Intersection info
@@ -204,7 +296,7 @@ struct FeatureDetailedInfo{
     FeatureIdx id;                              // Feature id
     FeatureType featureType;                    // Type of the feature
     TypedOSMID  featureOSMID;                   // OSMID of the feature
-    std::vector<ezgl::point2d> featurePoints;   // Coordinates of the feature in point2d
+    GeometryRange featurePoints;                // Coordinates of the feature in point2d
     double featureArea;
 
     double temp_max_lat, temp_max_lon;          // For temporary storage only
@@ -235,7 +327,7 @@ extern std::multimap<std::string, POIDetailedInfo> POI_AllFood;
 // Keys: OSMID, Value: vector of (tag, value) pairs
 extern std::unordered_map<OSMID, std::vector<std::pair<std::string, std::string>>> OSMID_Nodes_AllTagPairs;
 // Keys: OSMID, Value: Type of highway of corresponding wayOSMID (only for segments)
-extern std::unordered_map<OSMID, std::string> OSMID_Highway_Type;
+extern std::unordered_map<OSMID, HighwayType> OSMID_Highway_Type;
 // Stores subway relation information
 struct SubwayRoutes
 {
@@ -244,7 +336,7 @@ struct SubwayRoutes
     // Members - ordered (same index and same size)
     std::vector<std::string> roles;     // Roles of each member
     std::vector<TypedOSMID> members;    // TypedOSMID of each members. Can check type (Way/Node/Relations)
-    std::vector<std::vector<ezgl::point2d>> track_points;    // Vector of vector of point2d for points along all raiway=subway
+    std::vector<GeometryRange> track_points;    // Points along each railway=subway way of the route
 };
 // Stores subway station information
 struct SubwayStation
@@ -267,38 +359,31 @@ const double DEFAULT_TURN_PENALTY = 15;
 // Max speed limit of a street in the city
 extern double MAX_SPEED_LIMIT;
 
-// A struct to represent a node in the search graph (A* algorithm)
-struct Node
+// Compressed-sparse-row (CSR) adjacency of the street network, built once in m1_init
+// Path finding only reads these flat arrays, never the display structs above
+// Outgoing edges of intersection id are the indices [offsets[id], offsets[id + 1])
+// Each edge is one legal traversal of a street segment: one-way segments only appear in their legal
+// direction, and self-connecting segments (cul-de-sacs) appear once
+struct RoutingGraph
 {
-    IntersectionIdx id;
-    double g;       // g-value (cost of path from start node to this node)
-    double h;       // h-value (heuristic estimate of cost from this node to goal node)
-                    // NOTE that h-value must never overestimate the cost to reach the goal
-                    // Therefore, h = Euclidean distance to goal node / Largest speed limit in the city
-
-    IntersectionIdx parent;     // node that leads to this node on the shortest path found so far
-    StreetSegmentIdx parent_segment;      // segment (with least travel time) that leads to this node
-    // Compare the f-value (f = g + h) between 2 nodes
-    // Used to set up ascending priority queue (pops the smallest value first)
-    bool operator< (const Node& other) const
-    {
-        return (g + h) > (other.g + other.h);
-    }
-};
-
-// Node with less information (Multidestination Djakstra)
-struct NodeMulti
-{
-    IntersectionIdx id;
-    float g;        // g-value (cost of path from start node to this node)
-    IntersectionIdx parent;     // node that leads to this node on the shortest path found so far
-    StreetSegmentIdx parent_segment;      // segment (with least travel time) that leads to this node
-    // Used to set up ascending priority queue (pops the smallest value first)
-    bool operator< (const NodeMulti& other) const
-    {
-        return g > other.g;
-    }
+    std::vector<int> offsets;                       // Size intersectionNum + 1
+    std::vector<LatLon> position_latlon;            // Index: Intersection id, Value: position (for heuristics)
+    std::vector<IntersectionIdx> edge_from;         // Intersection the edge leaves from
+    std::vector<IntersectionIdx> edge_to;           // Intersection reached by taking the edge
+    std::vector<StreetSegmentIdx> edge_segment;     // Street segment travelled along
+    std::vector<double> edge_travel_time;           // Travel time of the segment, in seconds
+    std::vector<StreetIdx> edge_street;             // Street of the segment (to determine turn penalties)
+    // Reverse adjacency: edges entering intersection id are in_edges[in_offsets[id] .. in_offsets[id + 1])
+    std::vector<int> in_offsets;                    // Size intersectionNum + 1
+    std::vector<int> in_edges;                      // Edge indices (into the arrays above)
+    // Strongly connected components: intersections of a component can all reach each other
+    // Ids are in reverse topological order (edges between components go to lower ids)
+    std::vector<int> component;                     // Index: Intersection id, Value: component id
+    // Components reached by an edge leaving component c: component_edges[component_offsets[c] .. component_offsets[c + 1])
+    std::vector<int> component_offsets;
+    std::vector<int> component_edges;
 };
+extern RoutingGraph Routing_Graph;
 
 // All points where pins will be drawn on - Cleared and Modified based on user input
 extern std::vector<ezgl::point2d> pin_display_start;
@@ -26,74 +26,37 @@ void Grid::draw_grid_features (ezgl::renderer* g, double limit)
 ********************************************************************************/
 void Grid::draw_grid_segments (ezgl::renderer* g)
 {
-    for (auto segment : this->Grid_Segments_Non_Motorway)
+    // Draws different amount of data based on different zoom levels: one table lookup per segment
+    int zoom_level = street_zoom_level();
+    auto draw_segment = [&](StreetSegmentIdx segment)
     {
         // Skip segment if segment is part of found_path (will be drawn later)
         // Skip segment if it's already drawn (by other grids)
-        if (std::find(found_path.begin(), found_path.end(), segment.id) != found_path.end()
-            || check_segment_drawn[segment.id])
+        if (std::find(found_path.begin(), found_path.end(), segment) != found_path.end()
+            || check_segment_drawn[segment])
         {
-            continue;
+            return;
         }
-        check_segment_drawn[segment.id] = true;
+        check_segment_drawn[segment] = true;
 
-        // Draws different amount of data based on different zoom levels
-        if (curr_world_width >= ZOOM_LIMIT_0)
-        {
-            if (segment.highway_type == "primary")
-            {
-                draw_street_segment_pixel(g, segment);
-            }
-        } else if (ZOOM_LIMIT_1 <= curr_world_width && curr_world_width < ZOOM_LIMIT_0)
+        SegmentDrawMode mode = SEGMENT_DRAW_MODE[zoom_level][Street_Segments.highway_type[segment]];
+        if (mode == SEGMENT_PIXELS)
         {
-            if (segment.highway_type == "primary" || segment.highway_type == "trunk" || segment.highway_type == "secondary")
-            {   
-                draw_street_segment_pixel(g, segment);
-            }
-        } else if (ZOOM_LIMIT_2 <= curr_world_width && curr_world_width < ZOOM_LIMIT_1)
-        {
-            if (segment.highway_type == "primary" || segment.highway_type == "trunk" 
-                || segment.highway_type == "secondary" || segment.highway_type == "tertiary")
-            {
-                draw_street_segment_pixel(g, segment);
-            }
-        } else
+            draw_street_segment_pixel(g, segment);
+        } else if (mode == SEGMENT_METERS)
         {
-            // Only display all types of street (except for highway for later) when < ZOOM_LIMIT_3
-            if (ZOOM_LIMIT_3 <= curr_world_width && curr_world_width < ZOOM_LIMIT_2)
-            {
-                if (segment.highway_type == "primary" || segment.highway_type == "trunk"
-                    || segment.highway_type == "secondary" || segment.highway_type == "tertiary" 
-                    || segment.highway_type == "unclassified" || segment.highway_type == "residential")
-                {
-                    draw_street_segment_meters(g, segment);
-                }
-            } else if (curr_world_width < ZOOM_LIMIT_3 && segment.highway_type != "motorway" && segment.highway_type != "motorway_link")
-            {
-                draw_street_segment_meters(g, segment);
-            }
+            draw_street_segment_meters(g, segment);
         }
-    }
+    };
 
+    for (StreetSegmentIdx segment : this->Grid_Segments_Non_Motorway)
+    {
+        draw_segment(segment);
+    }
     // Draw motorway and motorway-link (highways) above other streets
-    for (auto segment : this->Grid_Segments_Motorway)
+    for (StreetSegmentIdx segment : this->Grid_Segments_Motorway)
     {
-        // Skip segment if segment is part of found_path (will be drawn later)
-        // Skip segment if it's already drawn (by other grids)
-        if (std::find(found_path.begin(), found_path.end(), segment.id) != found_path.end()
-            || check_segment_drawn[segment.id])
-        {
-            continue;
-        }
-        check_segment_drawn[segment.id] = true;
-
-        if (curr_world_width >= ZOOM_LIMIT_2 && segment.highway_type == "motorway")
-        {
-            draw_street_segment_pixel(g, segment);
-        } else if (curr_world_width < ZOOM_LIMIT_2)
-        {
-            draw_street_segment_meters(g, segment);
-        }
+        draw_segment(segment);
     }
 }
 
@@ -103,15 +66,15 @@ void Grid::draw_grid_segments (ezgl::renderer* g)
 // Draw street names in visible regions if region is available
 void Grid::draw_grid_names (ezgl::renderer *g)
 {
-    for (auto segment : this->Grid_Segments_Names)
+    for (StreetSegmentIdx segment : this->Grid_Segments_Names)
     {
         // Skip segment if it's already drawn (by other grids)
-        if (check_name_drawn[segment.id])
+        if (check_name_drawn[segment])
         {
             continue;
         }
-        check_name_drawn[segment.id] = true;
-        if (std::find(found_path.begin(), found_path.end(), segment.id) != found_path.end())
+        check_name_drawn[segment] = true;
+        if (std::find(found_path.begin(), found_path.end(), segment) != found_path.end())
         {
             draw_seg_name(g, segment, true);
         } else
@@ -14,9 +14,9 @@ class Grid
     public:
         std::vector<FeatureDetailedInfo> Grid_Features;
         std::vector<POIDetailedInfo> Grid_POIs;
-        std::vector<StreetSegmentDetailedInfo> Grid_Segments_Non_Motorway;
-        std::vector<StreetSegmentDetailedInfo> Grid_Segments_Motorway;
-        std::vector<StreetSegmentDetailedInfo> Grid_Segments_Names;
+        std::vector<StreetSegmentIdx> Grid_Segments_Non_Motorway;
+        std::vector<StreetSegmentIdx> Grid_Segments_Motorway;
+        std::vector<StreetSegmentIdx> Grid_Segments_Names;
         std::vector<IntersectionInfo> Grid_Intersections;
         std::vector<SubwayStation> Grid_Subway_Stations;
 
@@ -24,12 +24,20 @@
 #include "OSMDatabaseAPI.h"
 #include "draw/draw.hpp"
 #include "draw/utilities.hpp"
+#include "routing/contraction_hierarchy.hpp"
+#include "routing/landmarks.hpp"
+#include "routing/path_cache.hpp"
+#include "map_cache.h"
 #include <iostream>
 #include <set>
 #include <unordered_map>
 #include <cmath>
 #include <bits/stdc++.h>
 #include <cctype>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <omp.h>
 
 /*******************************************************************************************************************************
  * GLOBAL VARIABLES AND HELPER FUNCTION DECLARATION
@@ -40,20 +48,30 @@ Grid MapGrids[NUM_GRIDS][NUM_GRIDS];
 // *******************************************************************
 // Helper function Declaration
 // *******************************************************************
-void m1_init();
+void m1_init(const std::string& map_streets_database_filename, const std::string& map_osm_database_filename);
 void init_segments();
-std::vector<ezgl::point2d> get_poly_between_points (ezgl::point2d& point_1,
-                                                    ezgl::point2d& point_2,
-                                                    double width_meters);
+void index_segments();
+void get_poly_between_points (const ezgl::point2d& point_1,
+                              const ezgl::point2d& point_2,
+                              double width_meters,
+                              ezgl::point2d* corners);
 void init_intersections();
+void index_intersections();
+void init_routing_graph();
+void init_routing_components();
 void init_streets();
 void init_features();
+void index_features();
 void init_POI();
 void init_osm_nodes();
 void init_osm_ways();
+HighwayType highway_type_from_tag (const std::string& value);
 bool compareFeatureArea (FeatureDetailedInfo F1, FeatureDetailedInfo F2);
 void init_osm_relations_subways();
 ezgl::color get_rgb_color(std::string osm_color);
+// Run one stage of m1_init and record its timing in Load_Stage_Timings
+void run_load_stage (const std::string& stage, const std::function<void ()>& init_stage,
+                     std::chrono::steady_clock::time_point load_start);
 
 // *******************************************************************
 // Latlon bounds of current city
@@ -72,6 +90,13 @@ int streetNum;
 int featureNum;
 int POINum;
 
+// *******************************************************************
+// Map loading
+// *******************************************************************
+std::vector<LoadStageTiming> Load_Stage_Timings;
+// Stages running on other threads record their timing concurrently
+std::mutex load_timings_lock;
+
 // *******************************************************************
 // Shared variables
 // *******************************************************************
@@ -82,12 +107,20 @@ double clicked_intersection_distance;
 double clicked_POI_distance;
 // Max speed limit of current city
 double MAX_SPEED_LIMIT;
+// CSR adjacency used by all path searches
+RoutingGraph Routing_Graph;
+
+// *******************************************************************
+// Geometry
+// *******************************************************************
+// Points of all segment, feature and subway geometry (addressed by GeometryRange)
+std::vector<ezgl::point2d> Geometry_Points;
 
 // *******************************************************************
 // Street Segments
 // *******************************************************************
-// Index: Segment id, Value: Processed information of the segment
-std::vector<StreetSegmentDetailedInfo> Segment_SegmentDetailedInfo;
+// Index: Segment id (in each array), Value: Processed information of the segment
+StreetSegmentStore Street_Segments;
 
 // *******************************************************************
 // Intersections
@@ -129,7 +162,7 @@ std::multimap<std::string, POIDetailedInfo> POI_AllFood;
 // Keys: OSMID, Value: vector of (tag, value) pairs
 std::unordered_map<OSMID, std::vector<std::pair<std::string, std::string>>> OSMID_Nodes_AllTagPairs;
 // Keys: OSMID, Value: Type of highway of corresponding wayOSMID (only for segments)
-std::unordered_map<OSMID, std::string> OSMID_Highway_Type;
+std::unordered_map<OSMID, HighwayType> OSMID_Highway_Type;
 // Keys: index, Value: Subway relations of current world
 std::vector<SubwayRoutes> AllSubwayRoutes;
 // Key: subway station name, value: boolean to check if a station with the name has been drawn
@@ -164,7 +197,7 @@ bool loadMap (std::string map_streets_database_filename)
     {
         // Update the CURRENT_CITY based on first input
         CURRENT_MAP_PATH = map_streets_database_filename;
-        m1_init();
+        m1_init(map_streets_database_filename, map_osm_database_filename);
     }
     
     delete[] temp;
@@ -197,7 +230,7 @@ double findDistanceBetweenTwoPoints (LatLon point_1, LatLon point_2)
 // Speed Requirement --> moderate
 double findStreetSegmentLength (StreetSegmentIdx street_segment_id)
 {
-    return Segment_SegmentDetailedInfo[street_segment_id].length;
+    return Street_Segments.length[street_segment_id];
 }
 
 // Returns the travel time to drive from one end of a street segment 
@@ -206,7 +239,7 @@ double findStreetSegmentLength (StreetSegmentIdx street_segment_id)
 // Speed Requirement --> high 
 double findStreetSegmentTravelTime (StreetSegmentIdx street_segment_id)
 {
-    return Segment_SegmentDetailedInfo[street_segment_id].travel_time;
+    return Street_Segments.travel_time[street_segment_id];
 }
 
 // Returns all intersections reachable by traveling down one street segment 
@@ -224,16 +257,16 @@ std::vector<IntersectionIdx> findAdjacentIntersections(IntersectionIdx intersect
 
     for(auto& i : stSegments)
     {
-        if(Segment_SegmentDetailedInfo[i].from == Segment_SegmentDetailedInfo[i].to)
+        if(Street_Segments.from[i] == Street_Segments.to[i])
         {
-            adjacentIntersections.push_back(Segment_SegmentDetailedInfo[i].from);       // Corner case
+            adjacentIntersections.push_back(Street_Segments.from[i]);       // Corner case
             continue;
         }
-        if(Segment_SegmentDetailedInfo[i].to != intersection_id)                        // Can travel "to" -> always add
-            adjacentIntersections.push_back(Segment_SegmentDetailedInfo[i].to);
-        if(!Segment_SegmentDetailedInfo[i].oneWay && 
-            Segment_SegmentDetailedInfo[i].from != intersection_id)                     // If not one way and labelled as 
-                adjacentIntersections.push_back(Segment_SegmentDetailedInfo[i].from);   // from: intersection_id -> to: id_to_add
+        if(Street_Segments.to[i] != intersection_id)                        // Can travel "to" -> always add
+            adjacentIntersections.push_back(Street_Segments.to[i]);
+        if(!Street_Segments.one_way[i] && 
+            Street_Segments.from[i] != intersection_id)                     // If not one way and labelled as 
+                adjacentIntersections.push_back(Street_Segments.from[i]);   // from: intersection_id -> to: id_to_add
     }
     // Remove duplicate intersections (2 segments lead to 1 adjacent intersection)
     sort(adjacentIntersections.begin(), adjacentIntersections.end());
@@ -464,7 +497,8 @@ std::string getOSMNodeTagValue (OSMID OSMid, std::string key)
 void closeMap()
 {
     //Clean-up your map related data structures here
-    Segment_SegmentDetailedInfo.clear();
+    Street_Segments.clear();
+    Geometry_Points.clear();
     Intersection_IntersectionInfo.clear();
     IntersectionName_IntersectionIdx_no_repeat.clear();
     IntersectionName_IntersectionIdx.clear();
@@ -479,6 +513,30 @@ void closeMap()
     AllSubwayRoutes.clear();
     OSMID_NodeIndex.clear();
     OSMID_WayIndex.clear();
+    Routing_Graph.offsets.clear();
+    Routing_Graph.position_latlon.clear();
+    Routing_Graph.edge_from.clear();
+    Routing_Graph.edge_to.clear();
+    clear_landmarks();
+    Routing_Graph.edge_segment.clear();
+    Routing_Graph.edge_travel_time.clear();
+    Routing_Graph.edge_street.clear();
+    Routing_Graph.in_offsets.clear();
+    Routing_Graph.in_edges.clear();
+    Routing_Graph.component.clear();
+    Routing_Graph.component_offsets.clear();
+    Routing_Graph.component_edges.clear();
+    clear_contraction_hierarchy();
+    // Saved under the map the entries were found on: a city change sets CURRENT_MAP_PATH before closeMap
+    if (use_path_cache_file && !path_cache_map_path().empty())
+    {
+        std::string cache_filename = path_cache_file.empty() ? path_cache_path(path_cache_map_path()) : path_cache_file;
+        if (!save_path_cache(cache_filename))
+        {
+            std::cerr << "closeMap: could not write the path cache " << cache_filename << std::endl;
+        }
+    }
+    clear_path_cache();
     found_path.clear();
 
     // Clear data structures in grids
@@ -503,23 +561,98 @@ void closeMap()
 /*******************************************************************************************************************************
  * HELPER FUNCTIONS
  ********************************************************************************************************************************/
-void m1_init()
+void m1_init(const std::string& map_streets_database_filename, const std::string& map_osm_database_filename)
 {
+    auto load_start = std::chrono::steady_clock::now();
+    Load_Stage_Timings.clear();
+
     // Retrive total numbers from API
     segmentNum = getNumStreetSegments();
     streetNum = getNumStreets();
     intersectionNum = getNumIntersections();
     featureNum = getNumFeatures();
-    POINum = getNumPointsOfInterest();    
-    // Initialize database
-    init_features();
-    init_POI();
-    init_osm_ways();
-    init_segments();
-    init_streets();
-    init_intersections();
-    init_osm_nodes();
-    init_osm_relations_subways();
+    POINum = getNumPointsOfInterest();
+
+    // Initialize database. Stage dependencies:
+    //     features (city bounds, grid size) --> POI, segments, intersections, subways
+    //     osm ways (highway types) --> segments --> streets, routing graph --> components, hierarchy
+    //     (ALT landmarks are computed by the first search that needs them, see ensure_landmarks)
+    //     osm nodes, osm ways --> subways
+    // The OSM passes and init_streets only fill their own hash maps: they run on their own threads,
+    // while the stages on this thread split their per-element loops over OpenMP threads
+    auto osm_nodes = std::async(std::launch::async, run_load_stage, "osm nodes", init_osm_nodes, load_start);
+    auto osm_ways = std::async(std::launch::async, run_load_stage, "osm ways", init_osm_ways, load_start);
+
+    // A map cache written by an earlier load replaces the features, intersections, segments and routing graph
+    // stages (and so their wait for the osm ways): only the grids and name maps are rebuilt from it
+    std::string cache_filename = map_cache_path(map_streets_database_filename);
+    bool from_map_cache = false;
+    if (use_map_cache)
+    {
+        run_load_stage("map cache", [&]() {
+            from_map_cache = load_map_cache(cache_filename, map_streets_database_filename, map_osm_database_filename);
+        }, load_start);
+    }
+    if (from_map_cache)
+    {
+        run_load_stage("grids", []() { index_features(); index_intersections(); index_segments(); }, load_start);
+        run_load_stage("POI", init_POI, load_start);
+    } else
+    {
+        run_load_stage("features", init_features, load_start);
+        run_load_stage("POI", init_POI, load_start);
+        run_load_stage("intersections", init_intersections, load_start);
+        osm_ways.wait();
+        run_load_stage("segments", init_segments, load_start);
+    }
+    auto streets = std::async(std::launch::async, run_load_stage, "streets", init_streets, load_start);
+    if (!from_map_cache)
+    {
+        run_load_stage("routing graph", init_routing_graph, load_start);
+    }
+    run_load_stage("components", init_routing_components, load_start);
+    if (build_contraction_hierarchy_on_load)
+    {
+        run_load_stage("contraction hierarchy", []() { build_contraction_hierarchy(DEFAULT_TURN_PENALTY); }, load_start);
+    }
+    osm_nodes.get();
+    osm_ways.get();
+    run_load_stage("subways", init_osm_relations_subways, load_start);
+    streets.get();
+    if (use_map_cache && !from_map_cache)
+    {
+        run_load_stage("map cache write", [&]() {
+            if (!save_map_cache(cache_filename, map_streets_database_filename, map_osm_database_filename))
+            {
+                std::cerr << "m1_init: could not write the map cache " << cache_filename << std::endl;
+            }
+        }, load_start);
+    }
+
+    // Cached paths are only valid on the map they were found on
+    clear_path_cache();
+    if (use_path_cache_file)
+    {
+        load_path_cache(path_cache_file.empty() ? path_cache_path(map_streets_database_filename) : path_cache_file);
+    }
+
+    for (const LoadStageTiming& timing : Load_Stage_Timings)
+    {
+        std::cout << "m1_init: " << timing.stage << " " << timing.seconds << "s (started at " << timing.start << "s)\n";
+    }
+    std::cout << "m1_init: total " << std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count()
+              << "s" << std::endl;
+}
+
+void run_load_stage (const std::string& stage, const std::function<void ()>& init_stage,
+                     std::chrono::steady_clock::time_point load_start)
+{
+    auto stage_start = std::chrono::steady_clock::now();
+    init_stage();
+    auto stage_end = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> guard(load_timings_lock);
+    Load_Stage_Timings.push_back({stage, std::chrono::duration<double>(stage_start - load_start).count(),
+                                  std::chrono::duration<double>(stage_end - stage_start).count()});
 }
 
 // *******************************************************************
@@ -536,6 +669,9 @@ void init_features()
     double min_lat = max_lat;
     double min_lon = max_lon;
     
+    // Features are independent: bounds (then points and areas below) are computed in parallel
+    Features_AllInfo.resize(featureNum);
+    #pragma omp parallel for schedule(dynamic, 64) reduction(max: max_lat, max_lon) reduction(min: min_lat, min_lon)
     for (int featureIdx = 0; featureIdx < featureNum; featureIdx++)
     {
         FeatureDetailedInfo tempFeatureInfo;
@@ -563,7 +699,7 @@ void init_features()
         tempFeatureInfo.temp_min_lon = temp_min_lon;
 
         // Add Feature Info to Features_AllInfo
-        Features_AllInfo.push_back(tempFeatureInfo);
+        Features_AllInfo[featureIdx] = tempFeatureInfo;
 
         // Check if feature has max min lat lon of current world
         max_lat = std::max(temp_max_lat, max_lat);
@@ -585,19 +721,35 @@ void init_features()
     world_width = world_top_right.x - world_bottom_left.x;
     grid_width = world_width / NUM_GRIDS;
 
+    // Reserve the points of every feature in Geometry_Points (in feature id order), then fill them in parallel
+    std::size_t first_point = Geometry_Points.size();
+    for (int featureIdx = 0; featureIdx < featureNum; featureIdx++)
+    {
+        GeometryRange& featurePoints = Features_AllInfo[featureIdx].featurePoints;
+        featurePoints.first = first_point;
+        featurePoints.count = getNumFeaturePoints(featureIdx);
+        first_point += featurePoints.count;
+    }
+    Geometry_Points.resize(first_point);
+    #pragma omp parallel for schedule(dynamic, 64)
     for (int featureIdx = 0; featureIdx < featureNum; featureIdx++)
     {
-        //Load pre-processed data into Features_AllPoints
+        //Load pre-processed data into Geometry_Points
+        std::size_t first = Features_AllInfo[featureIdx].featurePoints.first;
         for (int pointIdx = 0; pointIdx < getNumFeaturePoints(featureIdx); pointIdx++)
         {
-            ezgl::point2d tempPoint = xy_from_latlon(getFeaturePoint(featureIdx, pointIdx));
-            Features_AllInfo[featureIdx].featurePoints.push_back(tempPoint);
+            Geometry_Points[first + pointIdx] = xy_from_latlon(getFeaturePoint(featureIdx, pointIdx));
         }
         Features_AllInfo[featureIdx].featureArea = findFeatureArea(featureIdx);
     }
     // Sort the Features_AllInfo based on descending feature areas
     std::sort(Features_AllInfo.begin(), Features_AllInfo.end(), compareFeatureArea);
+    index_features();
+}
 
+// Put the features into the grids (in order of descending area)
+void index_features()
+{
     for (auto feature : Features_AllInfo)
     {
         // Determine which grid(s) the feature belongs
@@ -657,20 +809,24 @@ LatLon latlon_from_xy(double x, double y)
 // POI
 // *******************************************************************
 void init_POI(){
+    POI_AllInfo.resize(POINum);
+    #pragma omp parallel for
     for (int tempIdx = 0; tempIdx < POINum; tempIdx++){
-        POIDetailedInfo tempPOIInfo;
+        POIDetailedInfo& tempPOIInfo = POI_AllInfo[tempIdx];
         tempPOIInfo.POIPoint = xy_from_latlon(getPOIPosition(tempIdx));
         tempPOIInfo.POIType = getPOIType(tempIdx);
         tempPOIInfo.POIName = getPOIName(tempIdx);
         tempPOIInfo.id = tempIdx;
-        POI_AllInfo.push_back(tempPOIInfo);
-        
+    }
+
+    // Grids are filled in id order
+    for (const POIDetailedInfo& tempPOIInfo : POI_AllInfo){
         // If POI is a food place, add to POI_AllFood
         // if (tempPOIInfo.POIType == "bar" || tempPOIInfo.POIType == "beer" || tempPOIInfo.POIType == "cafe" || tempPOIInfo.POIType == "cafe;fast_food" 
         //     || tempPOIInfo.POIType == "cater" || tempPOIInfo.POIType == "fast_food" || tempPOIInfo.POIType == "food_court" || tempPOIInfo.POIType == "ice_cream"
         //     || tempPOIInfo.POIType == "old_restaurant" || tempPOIInfo.POIType == "pub" || tempPOIInfo.POIType == "restaurant" || tempPOIInfo.POIType == "veterinary")
         // {
-        //     POI_AllFood.insert(std::make_pair(tempPOIInfo.POIName + " - " + std::to_string(tempIdx), tempPOIInfo));
+        //     POI_AllFood.insert(std::make_pair(tempPOIInfo.POIName + " - " + std::to_string(tempPOIInfo.id), tempPOIInfo));
         // }
 
         // Add POIs to grids
@@ -694,24 +850,39 @@ void init_POI(){
 // init_segments() must be done after init_osm_ways(), to record street type for each segments
 void init_segments()
 {
-    // Vector of StreetSegmentDetailedInfo (StreetSegmentIdx - StreetSegmentDetailedInfo)
+    // Fields of each segment go to Street_Segments (StreetSegmentIdx - one entry in each array)
+    // Segments are processed in parallel (geometry and polygons), then added to the grids in id order
+    Street_Segments.resize(segmentNum);
+    // Reserve the curve points and polygon corners of every segment in Geometry_Points first (in id order),
+    // so the parallel loop fills its own part of a single allocation
+    std::size_t first_point = Geometry_Points.size();
+    for (int segment = 0; segment < segmentNum; segment++)
+    {
+        int num_curve_points = getStreetSegmentInfo(segment).numCurvePoints;
+        Street_Segments.curve_points_xy[segment] = {first_point, (std::size_t) num_curve_points};
+        first_point += num_curve_points;
+        Street_Segments.poly_points[segment] = {first_point, (std::size_t) (num_curve_points + 1) * POLY_CORNERS};
+        first_point += Street_Segments.poly_points[segment].count;
+    }
+    Geometry_Points.resize(first_point);
+    double max_speed_limit = MAX_SPEED_LIMIT;
+    #pragma omp parallel for schedule(dynamic, 256) reduction(max: max_speed_limit)
     for (int segment = 0; segment < segmentNum; segment++)                  // Corresponds to id of all street segments
     {                 
         StreetSegmentInfo rawInfo = getStreetSegmentInfo(segment);          // Raw info object   
-        StreetSegmentDetailedInfo processedInfo;                            // Processed info object
         
-        processedInfo.id = segment;
-        processedInfo.wayOSMID = rawInfo.wayOSMID;
-        processedInfo.highway_type = OSMID_Highway_Type.at(rawInfo.wayOSMID);
-        processedInfo.from = rawInfo.from;
-        processedInfo.to = rawInfo.to;
-        processedInfo.oneWay = rawInfo.oneWay;
-        processedInfo.streetID = rawInfo.streetID;
-        processedInfo.numCurvePoints = rawInfo.numCurvePoints;
-        processedInfo.streetName = getStreetName(processedInfo.streetID);       // (get the name of the street that each segment belongs to - for m2)
+        Street_Segments.way_osmid[segment] = rawInfo.wayOSMID;
+        HighwayType highway_type = OSMID_Highway_Type.at(rawInfo.wayOSMID);
+        Street_Segments.highway_type[segment] = highway_type;
+        Street_Segments.from[segment] = rawInfo.from;
+        Street_Segments.to[segment] = rawInfo.to;
+        Street_Segments.one_way[segment] = rawInfo.oneWay;
+        Street_Segments.street[segment] = rawInfo.streetID;
+        Street_Segments.street_name[segment] = getStreetName(rawInfo.streetID);    // (get the name of the street that each segment belongs to - for m2)
        
         // Determine the width (in meters) of each street segment based on their type
-        processedInfo.width = get_street_width_meters(processedInfo.highway_type);
+        int width = get_street_width_meters(highway_type);
+        Street_Segments.width[segment] = width;
         
         // Find max and min x, y for defining bounds of each segment
         // Based on bounds, we can add each segments to corresponding grids
@@ -719,8 +890,8 @@ void init_segments()
         LatLon to_latlon = getIntersectionPosition(rawInfo.to);
         ezgl::point2d from_xy = xy_from_latlon(point_1_latlon);
         ezgl::point2d to_xy = xy_from_latlon(to_latlon);
-        processedInfo.from_xy = from_xy;
-        processedInfo.to_xy = to_xy;
+        Street_Segments.from_xy[segment] = from_xy;
+        Street_Segments.to_xy[segment] = to_xy;
         // Compare to get max min xy of each segment
         double max_x = std::max(to_xy.x, from_xy.x);
         double max_y = std::max(to_xy.y, from_xy.y);
@@ -730,27 +901,30 @@ void init_segments()
         // Pre-calculate length of each street segments (including curve points)
         // Length between 2 points are mote accurate with LatLon (latavg is average of the 2 points, not the whole world)
         ezgl::point2d point_1_xy = from_xy;
+        double length;
+        ezgl::point2d* curve_points_xy = &Geometry_Points[Street_Segments.curve_points_xy[segment].first];
+        ezgl::point2d* poly_points = &Geometry_Points[Street_Segments.poly_points[segment].first];
         // Determine bounds of each segment
         if (rawInfo.numCurvePoints == 0)
         {
-            processedInfo.length = findDistanceBetweenTwoPoints(point_1_latlon, to_latlon);
+            length = findDistanceBetweenTwoPoints(point_1_latlon, to_latlon);
             // Get polygon linking 2 points
-            processedInfo.poly_points.push_back(get_poly_between_points(from_xy, to_xy, processedInfo.width));
+            get_poly_between_points(from_xy, to_xy, width, poly_points);
         } else
         {
             // Starting length
-            processedInfo.length = 0.0; 
+            length = 0.0; 
             // Iterate through all curve points
             for (int i = 0; i < rawInfo.numCurvePoints; i++)
             {
                 LatLon point_2_latlon = getStreetSegmentCurvePoint(segment, i);
-                processedInfo.length += findDistanceBetweenTwoPoints(point_1_latlon, point_2_latlon);
+                length += findDistanceBetweenTwoPoints(point_1_latlon, point_2_latlon);
                 // Save the xy of curve points for drawing
                 ezgl::point2d point_2_xy = xy_from_latlon(point_2_latlon);
-                processedInfo.curvePoints_xy.push_back(point_2_xy);
+                curve_points_xy[i] = point_2_xy;
                 // Get polygon linking 2 (curve) points
                 point_1_xy = xy_from_latlon(point_1_latlon);
-                processedInfo.poly_points.push_back(get_poly_between_points(point_1_xy, point_2_xy, processedInfo.width));
+                get_poly_between_points(point_1_xy, point_2_xy, width, poly_points + i * POLY_CORNERS);
                 // Compare to get max min xy of each segment
                 max_x = std::max(point_2_xy.x, max_x);
                 max_y = std::max(point_2_xy.y, max_y);
@@ -760,28 +934,26 @@ void init_segments()
                 point_1_latlon = point_2_latlon;
             }
             // point_1_latlon is now the last curve point. Need to add distance to to_latlon
-            processedInfo.length += findDistanceBetweenTwoPoints(point_1_latlon, to_latlon);
+            length += findDistanceBetweenTwoPoints(point_1_latlon, to_latlon);
             // Get polygon linking 2 points
             point_1_xy = xy_from_latlon(point_1_latlon);
-            processedInfo.poly_points.push_back(get_poly_between_points(point_1_xy, to_xy, processedInfo.width));
+            get_poly_between_points(point_1_xy, to_xy, width, poly_points + rawInfo.numCurvePoints * POLY_CORNERS);
         }
+        Street_Segments.length[segment] = length;
 
         // Record the rectangle that bounds segment
-        processedInfo.segmentRectangle = ezgl::rectangle({min_x, min_y},
-                                                         {max_x, max_y});
+        Street_Segments.bounds[segment] = ezgl::rectangle({min_x, min_y},
+                                                          {max_x, max_y});
 
         // Pre-calculate travel time of each street segments
         // Record the max speed limit of a street in the city (for A* path finding)
-        processedInfo.travel_time = processedInfo.length / rawInfo.speedLimit;
-        if (rawInfo.speedLimit > MAX_SPEED_LIMIT)
-        {
-            MAX_SPEED_LIMIT = rawInfo.speedLimit;
-        }
+        Street_Segments.travel_time[segment] = length / rawInfo.speedLimit;
+        max_speed_limit = std::max(max_speed_limit, (double) rawInfo.speedLimit);
 
         // Calculate the angle to be rotated to draw name on segment; and street names appended with arrows
         // TODO: Curved segments!
         double angle_degree;
-        std::string streetName_arrow = processedInfo.streetName;
+        std::string streetName_arrow = Street_Segments.street_name[segment];
         if (from_xy.x == to_xy.x)
         {
             if (from_xy.y > to_xy.y)
@@ -800,36 +972,43 @@ void init_segments()
             if (slope >= 0)
             {
                 angle_degree = atan2(abs(to_xy.y - from_xy.y), abs(to_xy.x - from_xy.x)) / kDegreeToRadian;
-                if (processedInfo.oneWay && from_xy.y > to_xy.y) 
+                if (rawInfo.oneWay && from_xy.y > to_xy.y) 
                 {
                     streetName_arrow = "<- " + streetName_arrow;
-                } else if (processedInfo.oneWay)
+                } else if (rawInfo.oneWay)
                 {
                     streetName_arrow = streetName_arrow + " ->";
                 }
             } else
             {
                 angle_degree = 360 - atan2(abs(to_xy.y - from_xy.y), abs(to_xy.x - from_xy.x)) / kDegreeToRadian;
-                if (processedInfo.oneWay && from_xy.y < to_xy.y)
+                if (rawInfo.oneWay && from_xy.y < to_xy.y)
                 {
                     streetName_arrow = "<- " + streetName_arrow;
-                } else if (processedInfo.oneWay)
+                } else if (rawInfo.oneWay)
                 {
                     streetName_arrow = streetName_arrow + " ->";
                 }
             }
         }
-        processedInfo.streetName_arrow = streetName_arrow;
-        processedInfo.angle_degree = angle_degree;
-
-        // Push processed info into vector
-        Segment_SegmentDetailedInfo.push_back(processedInfo);
+        Street_Segments.street_name_arrow[segment] = streetName_arrow;
+        Street_Segments.angle_degree[segment] = angle_degree;
+    }
+    MAX_SPEED_LIMIT = max_speed_limit;
+    index_segments();
+}
 
+// Put the segments into the grids, in id order
+void index_segments()
+{
+    for (StreetSegmentIdx segment = 0; segment < Street_Segments.size(); segment++)
+    {
         // Determine which grid(s) the segment belongs
-        int col_max = (max_x - world_bottom_left.x) / grid_width;
-        int col_min = (min_x - world_bottom_left.x) / grid_width;
-        int row_max = (max_y - world_bottom_left.y) / grid_height;
-        int row_min = (min_y - world_bottom_left.y) / grid_height;
+        const ezgl::rectangle& bounds = Street_Segments.bounds[segment];
+        int col_max = (bounds.right() - world_bottom_left.x) / grid_width;
+        int col_min = (bounds.left() - world_bottom_left.x) / grid_width;
+        int row_max = (bounds.top() - world_bottom_left.y) / grid_height;
+        int row_min = (bounds.bottom() - world_bottom_left.y) / grid_height;
 
         // Put the segments into the grids
         // If feature has bounds at the edge of map, but to grid NUM_GRIDS - 1
@@ -842,31 +1021,32 @@ void init_segments()
             row_max = NUM_GRIDS - 1;
         }
 
+        HighwayType highway_type = Street_Segments.highway_type[segment];
         for (int i = row_min; i <= row_max; i++)
         {
             for (int j = col_min; j <= col_max; j++)
             {
-                if (processedInfo.highway_type == "motorway" || processedInfo.highway_type == "motorway_link")
+                if (highway_type == HIGHWAY_MOTORWAY || highway_type == HIGHWAY_MOTORWAY_LINK)
                 {
-                    MapGrids[i][j].Grid_Segments_Motorway.push_back(processedInfo);
+                    MapGrids[i][j].Grid_Segments_Motorway.push_back(segment);
                 } else
                 {
-                    MapGrids[i][j].Grid_Segments_Non_Motorway.push_back(processedInfo);
+                    MapGrids[i][j].Grid_Segments_Non_Motorway.push_back(segment);
                 }
 
-                if (processedInfo.streetName != "<unknown>")
+                if (Street_Segments.street_name[segment] != "<unknown>")
                 {
-                    MapGrids[i][j].Grid_Segments_Names.push_back(processedInfo);
+                    MapGrids[i][j].Grid_Segments_Names.push_back(segment);
                 }
             }
         }
     }
 }
 
-// Get the polygon connecting 2 points (used for draw_pixel_meters)
-std::vector<ezgl::point2d> get_poly_between_points (ezgl::point2d& point_1, ezgl::point2d& point_2, double width_meters)
+// Write the POLY_CORNERS corners of the polygon connecting 2 points to corners (used for draw_street_segment_meters)
+void get_poly_between_points (const ezgl::point2d& point_1, const ezgl::point2d& point_2, double width_meters,
+                              ezgl::point2d* corners)
 {
-    std::vector<ezgl::point2d> points;
     double delta_x, delta_y;
     if (point_1.y == point_2.y)
     {   
@@ -883,11 +1063,10 @@ std::vector<ezgl::point2d> get_poly_between_points (ezgl::point2d& point_1, ezgl
     ezgl::point2d point_b(point_2.x + delta_x, point_2.y + delta_y);
     ezgl::point2d point_c(point_2.x - delta_x, point_2.y - delta_y);
     ezgl::point2d point_d(point_1.x - delta_x, point_1.y - delta_y);
-    points.push_back(point_a);
-    points.push_back(point_b);
-    points.push_back(point_c);
-    points.push_back(point_d);
-    return points;
+    corners[0] = point_a;
+    corners[1] = point_b;
+    corners[2] = point_c;
+    corners[3] = point_d;
 }
 
 // *******************************************************************
@@ -899,19 +1078,18 @@ void init_streets()
     for(int seg_id = 0; seg_id < segmentNum; seg_id++)
     {
         // Info of current segment
-        StreetSegmentDetailedInfo segmentInfo = Segment_SegmentDetailedInfo[seg_id];
-        StreetIdx street_id = segmentInfo.streetID;
+        StreetIdx street_id = Street_Segments.street[seg_id];
         // Populate Street_StreetInfo based on streetID
         if (Street_StreetInfo.find(street_id) == Street_StreetInfo.end())
         {
             StreetInfo street_info;
             street_info.id = street_id;
             street_info.name = getStreetName(street_id);
-            street_info.length = segmentInfo.length;
+            street_info.length = Street_Segments.length[seg_id];
 
             street_info.all_segments.push_back(seg_id);
-            street_info.all_intersections.push_back(Segment_SegmentDetailedInfo[seg_id].from);
-            street_info.all_intersections.push_back(Segment_SegmentDetailedInfo[seg_id].to);
+            street_info.all_intersections.push_back(Street_Segments.from[seg_id]);
+            street_info.all_intersections.push_back(Street_Segments.to[seg_id]);
             Street_StreetInfo.insert(std::make_pair(street_id, street_info));
         } else
         {
@@ -919,11 +1097,11 @@ void init_streets()
             Street_StreetInfo.at(street_id).all_segments.push_back(seg_id);
             // Push intersections into street info
             // Intersections will appear duplicates here. Intersections will be sorted and duplicates will be removed in next for loop
-            Street_StreetInfo.at(street_id).all_intersections.push_back(Segment_SegmentDetailedInfo[seg_id].from);
-            Street_StreetInfo.at(street_id).all_intersections.push_back(Segment_SegmentDetailedInfo[seg_id].to);
+            Street_StreetInfo.at(street_id).all_intersections.push_back(Street_Segments.from[seg_id]);
+            Street_StreetInfo.at(street_id).all_intersections.push_back(Street_Segments.to[seg_id]);
 
             // Add segment length to street
-            Street_StreetInfo.at(street_id).length += Segment_SegmentDetailedInfo[seg_id].length;
+            Street_StreetInfo.at(street_id).length += Street_Segments.length[seg_id];
         }
     }
 
@@ -944,53 +1122,42 @@ void init_streets()
 // *******************************************************************
 // Intersections
 // *******************************************************************
-// init_intersections() must be done after init_segments(), to identify adjacent intersections and the segments to them
+// init_intersections() must be done after init_features(), to place intersections in the grids
 void init_intersections()
 {
     Intersection_IntersectionInfo.resize(intersectionNum);
 
+    // Pre-process information for all intersections (in parallel)
+    #pragma omp parallel for schedule(dynamic, 256)
     for (IntersectionIdx id = 0; id < intersectionNum; id++)
-    {     
+    {
         // Record intersection names
-        std::string name = getIntersectionName(id);
-        Intersection_IntersectionInfo[id].name = name;
-        // Populate data structures to allow searching for intersection by name
-        IntersectionName_IntersectionIdx_no_repeat.insert(std::make_pair(name, id));
-        IntersectionName_IntersectionIdx.insert(std::make_pair(name, id));
-        IntersectionName_lower_IntersectionIdx.insert(std::make_pair(lower_no_space(name), id));
-
-        // Pre-process information for all intersections
+        Intersection_IntersectionInfo[id].name = getIntersectionName(id);
         Intersection_IntersectionInfo[id].position_latlon = getIntersectionPosition(id);
-        ezgl::point2d inter_xy = xy_from_latlon(getIntersectionPosition(id));
-        Intersection_IntersectionInfo[id].position_xy = inter_xy;
+        Intersection_IntersectionInfo[id].position_xy = xy_from_latlon(getIntersectionPosition(id));
 
         // Populate vector of all segments connecting to the intersection
         for(int segment = 0; segment < getNumIntersectionStreetSegment(id); segment++) {
             StreetSegmentIdx ss_id = getIntersectionStreetSegment(id, segment);
             Intersection_IntersectionInfo[id].all_segments.push_back(ss_id);
         }
+    }
+    index_intersections();
+}
 
-        // Pre-load all neighbors of an intersection, along with street segments to that neighbor
-        std::vector<IntersectionIdx> neighbors = findAdjacentIntersections(id);
-        for (IntersectionIdx neighbor : neighbors)
-        {
-            std::vector<StreetSegmentIdx> connecting_segments;
-            for (StreetSegmentIdx streetSegment : Intersection_IntersectionInfo[id].all_segments)
-            {
-                IntersectionIdx from = Segment_SegmentDetailedInfo[streetSegment].from;
-                IntersectionIdx to = Segment_SegmentDetailedInfo[streetSegment].to;
-                if (from == id && to == neighbor)
-                {
-                    connecting_segments.push_back(streetSegment);
-                } else if (!Segment_SegmentDetailedInfo[streetSegment].oneWay && from == neighbor && to == id)
-                {
-                    connecting_segments.push_back(streetSegment);
-                }
-            }
-            Intersection_IntersectionInfo[id].neighbors_and_segments.push_back(std::make_pair(neighbor, connecting_segments));
-        }
+// Fill the intersection name maps and put the intersections into the grids, in id order
+void index_intersections()
+{
+    for (IntersectionIdx id = 0; id < intersectionNum; id++)
+    {
+        // Populate data structures to allow searching for intersection by name
+        const std::string& name = Intersection_IntersectionInfo[id].name;
+        IntersectionName_IntersectionIdx_no_repeat.insert(std::make_pair(name, id));
+        IntersectionName_IntersectionIdx.insert(std::make_pair(name, id));
+        IntersectionName_lower_IntersectionIdx.insert(std::make_pair(lower_no_space(name), id));
 
         // Add Intersections to grids
+        ezgl::point2d inter_xy = Intersection_IntersectionInfo[id].position_xy;
         int row = (inter_xy.y - world_bottom_left.y) / grid_height;
         int col = (inter_xy.x - world_bottom_left.x) / grid_width;
         if (row >= NUM_GRIDS)
@@ -1005,6 +1172,176 @@ void init_intersections()
     }
 }
 
+// *******************************************************************
+// Routing Graph
+// *******************************************************************
+// init_routing_graph() must be done after init_segments(), to read the endpoints and travel time of each segment
+// Builds the CSR adjacency in two passes: count outgoing edges of each intersection, then fill the edges
+void init_routing_graph()
+{
+    Routing_Graph.offsets.assign(intersectionNum + 1, 0);
+    Routing_Graph.position_latlon.resize(intersectionNum);
+    for (IntersectionIdx id = 0; id < intersectionNum; id++)
+    {
+        Routing_Graph.position_latlon[id] = getIntersectionPosition(id);
+    }
+
+    // Count the outgoing edges of each intersection (stored shifted by one for the prefix sum)
+    for (StreetSegmentIdx segment = 0; segment < segmentNum; segment++)
+    {
+        IntersectionIdx from = Street_Segments.from[segment];
+        IntersectionIdx to = Street_Segments.to[segment];
+        Routing_Graph.offsets[from + 1]++;
+        if (!Street_Segments.one_way[segment] && from != to)
+        {
+            Routing_Graph.offsets[to + 1]++;
+        }
+    }
+    for (IntersectionIdx id = 0; id < intersectionNum; id++)
+    {
+        Routing_Graph.offsets[id + 1] += Routing_Graph.offsets[id];
+    }
+
+    // Fill the edges. insert_position is the next free edge slot of each intersection
+    int edgeNum = Routing_Graph.offsets[intersectionNum];
+    Routing_Graph.edge_from.resize(edgeNum);
+    Routing_Graph.edge_to.resize(edgeNum);
+    Routing_Graph.edge_segment.resize(edgeNum);
+    Routing_Graph.edge_travel_time.resize(edgeNum);
+    Routing_Graph.edge_street.resize(edgeNum);
+    std::vector<int> insert_position(Routing_Graph.offsets.begin(), Routing_Graph.offsets.end() - 1);
+    auto add_edge = [&](IntersectionIdx from, IntersectionIdx to, StreetSegmentIdx segment)
+    {
+        int edge = insert_position[from]++;
+        Routing_Graph.edge_from[edge] = from;
+        Routing_Graph.edge_to[edge] = to;
+        Routing_Graph.edge_segment[edge] = segment;
+        Routing_Graph.edge_travel_time[edge] = Street_Segments.travel_time[segment];
+        Routing_Graph.edge_street[edge] = Street_Segments.street[segment];
+    };
+    for (StreetSegmentIdx segment = 0; segment < segmentNum; segment++)
+    {
+        IntersectionIdx from = Street_Segments.from[segment];
+        IntersectionIdx to = Street_Segments.to[segment];
+        add_edge(from, to, segment);
+        if (!Street_Segments.one_way[segment] && from != to)
+        {
+            add_edge(to, from, segment);
+        }
+    }
+
+    // Reverse adjacency (edges entering each intersection), built the same way from the forward edges
+    Routing_Graph.in_offsets.assign(intersectionNum + 1, 0);
+    for (int edge = 0; edge < edgeNum; edge++)
+    {
+        Routing_Graph.in_offsets[Routing_Graph.edge_to[edge] + 1]++;
+    }
+    for (IntersectionIdx id = 0; id < intersectionNum; id++)
+    {
+        Routing_Graph.in_offsets[id + 1] += Routing_Graph.in_offsets[id];
+    }
+    Routing_Graph.in_edges.resize(edgeNum);
+    insert_position.assign(Routing_Graph.in_offsets.begin(), Routing_Graph.in_offsets.end() - 1);
+    for (int edge = 0; edge < edgeNum; edge++)
+    {
+        Routing_Graph.in_edges[insert_position[Routing_Graph.edge_to[edge]]++] = edge;
+    }
+}
+
+// init_routing_components() must be done after the routing graph is built or loaded from the map cache
+// Iterative Tarjan: components are found sinks first, which numbers them in reverse topological order
+void init_routing_components()
+{
+    Routing_Graph.component.assign(intersectionNum, -1);
+    std::vector<int> index(intersectionNum, -1);    // DFS visit order
+    std::vector<int> lowlink(intersectionNum, 0);   // Lowest index reachable from the DFS subtree still on the stack
+    std::vector<char> on_stack(intersectionNum, 0);
+    std::vector<IntersectionIdx> component_stack;
+    std::vector<std::pair<IntersectionIdx, int>> dfs_stack;    // (intersection, next edge to follow)
+    int next_index = 0;
+    int componentNum = 0;
+    auto visit = [&](IntersectionIdx id)
+    {
+        index[id] = lowlink[id] = next_index++;
+        component_stack.push_back(id);
+        on_stack[id] = 1;
+        dfs_stack.push_back(std::make_pair(id, Routing_Graph.offsets[id]));
+    };
+    for (IntersectionIdx root = 0; root < intersectionNum; root++)
+    {
+        if (index[root] != -1)
+        {
+            continue;
+        }
+        visit(root);
+        while (!dfs_stack.empty())
+        {
+            IntersectionIdx id = dfs_stack.back().first;
+            int edge = dfs_stack.back().second;
+            if (edge < Routing_Graph.offsets[id + 1])
+            {
+                dfs_stack.back().second++;
+                IntersectionIdx next = Routing_Graph.edge_to[edge];
+                if (index[next] == -1)
+                {
+                    visit(next);
+                } else if (on_stack[next])
+                {
+                    lowlink[id] = std::min(lowlink[id], index[next]);
+                }
+                continue;
+            }
+
+            // All edges followed: id closes a component if nothing on the stack below it is reachable
+            dfs_stack.pop_back();
+            if (!dfs_stack.empty())
+            {
+                IntersectionIdx parent = dfs_stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[id]);
+            }
+            if (lowlink[id] == index[id])
+            {
+                IntersectionIdx member;
+                do
+                {
+                    member = component_stack.back();
+                    component_stack.pop_back();
+                    on_stack[member] = 0;
+                    Routing_Graph.component[member] = componentNum;
+                } while (member != id);
+                componentNum++;
+            }
+        }
+    }
+
+    // Edges between components, in CSR form (an edge per routing graph edge, duplicates kept)
+    Routing_Graph.component_offsets.assign(componentNum + 1, 0);
+    int edgeNum = Routing_Graph.edge_to.size();
+    for (int edge = 0; edge < edgeNum; edge++)
+    {
+        int from = Routing_Graph.component[Routing_Graph.edge_from[edge]];
+        if (from != Routing_Graph.component[Routing_Graph.edge_to[edge]])
+        {
+            Routing_Graph.component_offsets[from + 1]++;
+        }
+    }
+    for (int component = 0; component < componentNum; component++)
+    {
+        Routing_Graph.component_offsets[component + 1] += Routing_Graph.component_offsets[component];
+    }
+    Routing_Graph.component_edges.resize(Routing_Graph.component_offsets[componentNum]);
+    std::vector<int> insert_position(Routing_Graph.component_offsets.begin(), Routing_Graph.component_offsets.end() - 1);
+    for (int edge = 0; edge < edgeNum; edge++)
+    {
+        int from = Routing_Graph.component[Routing_Graph.edge_from[edge]];
+        int to = Routing_Graph.component[Routing_Graph.edge_to[edge]];
+        if (from != to)
+        {
+            Routing_Graph.component_edges[insert_position[from]++] = to;
+        }
+    }
+}
+
 // *******************************************************************
 // OSM Data
 // *******************************************************************
@@ -1039,15 +1376,35 @@ void init_osm_ways()
             auto tag_pair = getTagPair(tempOSMWay, tagIdx);
             if (tag_pair.first == "highway")
             {
-                OSMID_Highway_Type.insert(std::make_pair(tempOSMID, tag_pair.second));
+                OSMID_Highway_Type.insert(std::make_pair(tempOSMID, highway_type_from_tag(tag_pair.second)));
             }
         }
     }
 }
 
+// Interned street type of the value of a "highway" tag
+HighwayType highway_type_from_tag (const std::string& value)
+{
+    const std::pair<const char*, HighwayType> known_types[] = {
+        {"motorway", HIGHWAY_MOTORWAY}, {"motorway_link", HIGHWAY_MOTORWAY_LINK}, {"trunk", HIGHWAY_TRUNK},
+        {"primary", HIGHWAY_PRIMARY}, {"secondary", HIGHWAY_SECONDARY}, {"tertiary", HIGHWAY_TERTIARY},
+        {"unclassified", HIGHWAY_UNCLASSIFIED}, {"residential", HIGHWAY_RESIDENTIAL}, {"path", HIGHWAY_PATH}};
+    for (const auto& known_type : known_types)
+    {
+        if (value == known_type.first)
+        {
+            return known_type.second;
+        }
+    }
+    return HIGHWAY_OTHER;
+}
+
 // Initialize necessary data for subway lines and stations
 void init_osm_relations_subways()
 {
+    // Track points of all routes are gathered here, then appended to Geometry_Points at once
+    std::vector<ezgl::point2d> track_points;
+    std::size_t first_point = Geometry_Points.size();
     // Loop thourgh all relations
     for (int relation = 0; relation < getNumberOfRelations(); ++relation)
     {
@@ -1095,13 +1452,12 @@ void init_osm_relations_subways()
                     // Get xy of all nodes forming ways of a subway
                     std::vector<OSMID> way_nodes = getWayMembers(currWay);
 
-                    std::vector<ezgl::point2d> curr_way_track_points;
+                    subway.track_points.push_back({first_point + track_points.size(), way_nodes.size()});
                     for (auto id : way_nodes)
                     {
                         const OSMNode* tempOSMNode = getNodeByIndex(OSMID_NodeIndex.at(id));
-                        curr_way_track_points.push_back(xy_from_latlon(getNodeCoords(tempOSMNode)));
+                        track_points.push_back(xy_from_latlon(getNodeCoords(tempOSMNode)));
                     }
-                    subway.track_points.push_back(curr_way_track_points);
                 }
                 // Subway stations 
                 else if ((subway.roles[i] == "stop") && (subway.members[i].type() == TypedOSMID::Node))
@@ -1136,6 +1492,7 @@ void init_osm_relations_subways()
             AllSubwayRoutes.push_back(subway);
         }
     }
+    Geometry_Points.insert(Geometry_Points.end(), track_points.begin(), track_points.end());
 }
 
 // Get ezgl::color from OSM color (string)
@@ -311,7 +311,7 @@ void draw_main_canvas (ezgl::renderer *g)
     ********************************************************************************/
     for (int i = 0; i < found_path.size(); i++)
     {
-        StreetSegmentDetailedInfo segment = Segment_SegmentDetailedInfo[found_path[i]];
+        StreetSegmentIdx segment = found_path[i];
         if (ZOOM_LIMIT_2 <= curr_world_width)
         {
             draw_street_segment_pixel(g, segment, true);
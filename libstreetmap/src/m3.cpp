@@ -22,10 +22,15 @@
 #include "m2.h"
 #include "m3.h"
 #include "globals.h"
-#include <queue>
-#include <unordered_set>
+#include "routing/routing.hpp"
+#include "routing/contraction_hierarchy.hpp"
+#include "routing/landmarks.hpp"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+
+// Statistics of the last search made by each thread
+thread_local SearchStats search_stats;
 
 // Returns the time required to travel along the path specified, in seconds.
 // The path is given as a vector of street segment ids, and this function can
@@ -38,22 +43,15 @@ double computePathTravelTime (const std::vector<StreetSegmentIdx>& path,
                              const double turn_penalty)
 {
     double travelTime = 0;
-    if(path.size() != 0)
-    {
-        for(int i = 0; i < path.size(); i++)
-        {
-            if(i < path.size() - 1
-                && Segment_SegmentDetailedInfo[path[i + 1]].streetID != Segment_SegmentDetailedInfo[path[i]].streetID)
-            {
-                travelTime += turn_penalty;
-            }
-            travelTime += Segment_SegmentDetailedInfo[path[i]].travel_time;
-        }
-        return travelTime;
-    } else
+    StreetIdx previous_street = -1;
+    for (StreetSegmentIdx segment : path)
     {
-        return 0;
+        StreetIdx street = Street_Segments.street[segment];
+        travelTime += turn_cost(previous_street, street, turn_penalty);
+        travelTime += Street_Segments.travel_time[segment];
+        previous_street = street;
     }
+    return travelTime;
 }
 
 
@@ -69,130 +67,394 @@ double computePathTravelTime (const std::vector<StreetSegmentIdx>& path,
 std::vector<StreetSegmentIdx> findPathBetweenIntersections (
                   const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
                   const double turn_penalty)
+{
+    // Edge-based A*: contraction hierarchies are opt-in until they are measured faster on real maps
+    return findPathAndTravelTime(intersect_ids, turn_penalty, PathSearchMode::EDGE_BASED).second;
+}
+
+// Dispatch to the selected search engine
+// The returned travel time is the g-value of the destination, equal to computePathTravelTime of the path
+std::pair<double, std::vector<StreetSegmentIdx>> findPathAndTravelTime (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty,
+                  PathSearchMode mode)
+{
+    // Settled counts of both workspace slots are added up afterwards (slot 1 is only used by bidirectional searches)
+    for (int slot = 0; slot < NUM_WORKSPACE_SLOTS; slot++)
+    {
+        get_search_workspace(slot).settled_count = 0;
+    }
+
+    std::pair<double, std::vector<StreetSegmentIdx>> result;
+    if (mode == PathSearchMode::NODE_BASED)
+    {
+        result = findPathNodeBased(intersect_ids, turn_penalty);
+    } else if (mode == PathSearchMode::BIDIRECTIONAL)
+    {
+        result = findPathBidirectional(intersect_ids, turn_penalty);
+    } else if (mode == PathSearchMode::CONTRACTION_HIERARCHY)
+    {
+        result = findPathContractionHierarchy(intersect_ids, turn_penalty);
+    } else
+    {
+        result = findPathEdgeBased(intersect_ids, turn_penalty);
+    }
+
+    search_stats.settled_states = 0;
+    for (int slot = 0; slot < NUM_WORKSPACE_SLOTS; slot++)
+    {
+        search_stats.settled_states += get_search_workspace(slot).settled_count;
+    }
+    return result;
+}
+
+const SearchStats& last_search_stats ()
+{
+    return search_stats;
+}
+
+// Landmark (ALT) bounds if landmarks were computed, else straight-line distance at MAX_SPEED_LIMIT
+double travel_time_lower_bound (IntersectionIdx from, IntersectionIdx to)
+{
+    if (ALT_Landmarks.count > 0)
+    {
+        return landmark_lower_bound(from, to);
+    }
+    return findDistanceBetweenTwoPoints(Routing_Graph.position_latlon[from], Routing_Graph.position_latlon[to]) / MAX_SPEED_LIMIT;
+}
+
+// Components have lower ids than the components leading to them: a single sweep down from from_component
+std::vector<char> reachable_components (int from_component)
+{
+    std::vector<char> reachable(Routing_Graph.component_offsets.size() - 1, 0);
+    reachable[from_component] = 1;
+    for (int component = from_component; component >= 0; component--)
+    {
+        if (!reachable[component])
+        {
+            continue;
+        }
+        for (int i = Routing_Graph.component_offsets[component]; i < Routing_Graph.component_offsets[component + 1]; i++)
+        {
+            reachable[Routing_Graph.component_edges[i]] = 1;
+        }
+    }
+    return reachable;
+}
+
+// A* search over intersections, using the shared turn cost model
+// Each intersection keeps only its best label, so under turn penalties a slower arrival on the same street
+// (which avoids a turn later) is discarded --> Not always optimal when turn_penalty > 0
+std::pair<double, std::vector<StreetSegmentIdx>> findPathNodeBased (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty)
 {
     std::vector<StreetSegmentIdx> result;
     IntersectionIdx start_id = intersect_ids.first;
     IntersectionIdx dest_id = intersect_ids.second;
-    
-    // Create the priority queue and the record_node hash table
-    std::priority_queue<Node> pq;
-    std::unordered_map<IntersectionIdx, Node> record_node;
-    // Keep track of visited node ids
-    std::unordered_set<IntersectionIdx> visited;
-
-    // Create the starting node
-    // Add the starting node to the priority queue (FIFO) and record_node hash table
-    double h_start = findDistanceBetweenTwoPoints(Intersection_IntersectionInfo[start_id].position_latlon, 
-                                                  Intersection_IntersectionInfo[dest_id].position_latlon) / MAX_SPEED_LIMIT;
-    Node startNode = {start_id, 0, h_start, -1, -1};
-    pq.push(startNode);
-    record_node.insert(std::make_pair(start_id, startNode));
+
+    ensure_landmarks();
+    // Search state is kept in the thread's workspace, indexed by intersection
+    SearchWorkspace& workspace = get_search_workspace();
+    workspace.start_search(Routing_Graph.offsets.size() - 1);
+    auto heuristic = [&](IntersectionIdx id)
+    {
+        return travel_time_lower_bound(id, dest_id);
+    };
+
+    // Add the starting node to the priority queue
+    workspace.set_label(start_id, 0, -1);
+    workspace.parent_segment[start_id] = -1;
+    workspace.parent_street[start_id] = -1;
+    workspace.push(heuristic(start_id), start_id);
 
     // A* algorithm
-    while (!pq.empty())
+    while (!workspace.heap.empty())
     {
-        // The current node to explore is the top node in the queue
-        // a.k.a node with smallest f-value
-        Node current = pq.top();
-        pq.pop();
+        // The current node to explore is the node with smallest f-value
+        IntersectionIdx current = workspace.pop().second;
+
+        // If current node is visited --> Skip to next node in priority queue
+        if (workspace.is_settled(current))
+        {
+            continue;
+        }
+        // Mark current node as visited
+        workspace.settle(current);
 
         // If current node is destination node
-        if (current.id == dest_id)
+        if (current == dest_id)
         {
             // Reconstruct the path from the goal node to the start node
-            while (current.parent != -1)
+            for (IntersectionIdx id = current; workspace.parent[id] != -1; id = workspace.parent[id])
             {
-                result.insert(result.begin(), current.parent_segment);
-                current = record_node[current.parent];
+                result.push_back(workspace.parent_segment[id]);
             }
-            break;
+            std::reverse(result.begin(), result.end());
+            return std::make_pair(workspace.g_value[dest_id], result);
         }
 
-        // If current node is visited --> Skip to next node in priority queue
-        if (visited.find(current.id) != visited.end())
+        // Explore all outgoing edges of the current node in the routing graph
+        // There may be multiple edges (segments) connecting 2 adjacent nodes, each relaxed on its own
+        // Segments may belong to different streets --> Must consider turn penalties
+        for (int edge = Routing_Graph.offsets[current]; edge < Routing_Graph.offsets[current + 1]; edge++)
         {
-            continue;
+            IntersectionIdx neighbor = Routing_Graph.edge_to[edge];
+            // If neighbor node is visited --> Skip to next neighbor
+            if (workspace.is_settled(neighbor))
+            {
+                continue;
+            }
+
+            // g-value for neighbor through this edge
+            // Add turn_penalty if taking this edge leads to a new street
+            double g = workspace.g_value[current] + turn_cost(workspace.parent_street[current], Routing_Graph.edge_street[edge], turn_penalty);
+            g += Routing_Graph.edge_travel_time[edge];
+
+            // Keep the path with least travel time to the neighbor
+            if (!workspace.has_label(neighbor) || g < workspace.g_value[neighbor])
+            {
+                workspace.set_label(neighbor, g, current);
+                workspace.parent_segment[neighbor] = Routing_Graph.edge_segment[edge];
+                workspace.parent_street[neighbor] = Routing_Graph.edge_street[edge];
+                workspace.push(g + heuristic(neighbor), neighbor);
+            }
         }
-        // Mark current node as visited
-        visited.insert(current.id);
+    }
+
+    // No path exists
+    return std::make_pair(0.0, result);
+}
+
+// A* search over the edges of the routing graph (edge-based / turn-aware search)
+// A search state is a routing graph edge, i.e. (intersection reached, segment used to reach it),
+// so the turn penalty of leaving an intersection is known exactly and the path found is optimal
+// The heuristic is the travel time lower bound from the edge's target intersection to the destination
+std::pair<double, std::vector<StreetSegmentIdx>> findPathEdgeBased (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty)
+{
+    std::vector<StreetSegmentIdx> result;
+    IntersectionIdx start_id = intersect_ids.first;
+    IntersectionIdx dest_id = intersect_ids.second;
+    if (start_id == dest_id)
+    {
+        return std::make_pair(0.0, result);
+    }
+
+    ensure_landmarks();
+    // Search state is kept in the thread's workspace, indexed by routing graph edge
+    SearchWorkspace& workspace = get_search_workspace();
+    workspace.start_search(Routing_Graph.edge_to.size());
+    auto heuristic = [&](IntersectionIdx id)
+    {
+        return travel_time_lower_bound(id, dest_id);
+    };
+
+    // Edges leaving the start intersection (no turn penalty)
+    for (int edge = Routing_Graph.offsets[start_id]; edge < Routing_Graph.offsets[start_id + 1]; edge++)
+    {
+        double g = Routing_Graph.edge_travel_time[edge];
+        workspace.set_label(edge, g, -1);
+        workspace.push(g + heuristic(Routing_Graph.edge_to[edge]), edge);
+    }
 
-        // Intersection Info for current node (to get neighbors and edges)
-        IntersectionInfo intersection = Intersection_IntersectionInfo[current.id];
-        // If current node has no neighbors --> skip
-        if (intersection.neighbors_and_segments.empty())
+    int dest_edge = -1;
+    while (!workspace.heap.empty())
+    {
+        int current = workspace.pop().second;
+
+        // Skip outdated queue entries
+        if (workspace.is_settled(current))
         {
             continue;
         }
+        workspace.settle(current);
 
-        // Explore all neighbors
-        for (std::pair<IntersectionIdx, std::vector<StreetSegmentIdx>> pair : intersection.neighbors_and_segments)
+        // The first edge reaching the destination is on an optimal path (consistent heuristic)
+        IntersectionIdx intersection = Routing_Graph.edge_to[current];
+        if (intersection == dest_id)
         {
-            // If neighbor node is visited --> Skip to next neighbor
-            if (visited.find(pair.first) != visited.end())
+            dest_edge = current;
+            break;
+        }
+
+        // Relax all edges leaving the intersection reached, with the turn penalty from the current edge
+        StreetIdx current_street = Routing_Graph.edge_street[current];
+        for (int edge = Routing_Graph.offsets[intersection]; edge < Routing_Graph.offsets[intersection + 1]; edge++)
+        {
+            if (workspace.is_settled(edge))
             {
                 continue;
             }
+            double g = workspace.g_value[current] + turn_cost(current_street, Routing_Graph.edge_street[edge], turn_penalty);
+            g += Routing_Graph.edge_travel_time[edge];
+            if (!workspace.has_label(edge) || g < workspace.g_value[edge])
+            {
+                workspace.set_label(edge, g, current);
+                workspace.push(g + heuristic(Routing_Graph.edge_to[edge]), edge);
+            }
+        }
+    }
 
-            // Calculate the h-value of the neighbor node (fixed for each node)
-            double h = findDistanceBetweenTwoPoints(Intersection_IntersectionInfo[pair.first].position_latlon,
-                                                    Intersection_IntersectionInfo[dest_id].position_latlon) / MAX_SPEED_LIMIT;
+    // No path exists
+    if (dest_edge == -1)
+    {
+        return std::make_pair(0.0, result);
+    }
 
-            // Get the street segments connecting the current node and the neighbor node
-            // There may be multiple segments connecting 2 adjacent nodes
-            // Segments may belong to different streets --> Must consider turn penalties
-            std::vector<StreetSegmentIdx> connectingStreetSegments = pair.second;
+    // Reconstruct the path from the destination edge back to the start
+    for (int edge = dest_edge; edge != -1; edge = workspace.parent[edge])
+    {
+        result.push_back(Routing_Graph.edge_segment[edge]);
+    }
+    std::reverse(result.begin(), result.end());
+    return std::make_pair(workspace.g_value[dest_edge], result);
+}
 
-            // g-value for neighbor = min g-value (travel time) of a connecting segment
-            double g = current.g + Segment_SegmentDetailedInfo[connectingStreetSegments[0]].travel_time;
-            if ((current.parent_segment != -1) && 
-                (Segment_SegmentDetailedInfo[current.parent_segment].streetName != Segment_SegmentDetailedInfo[connectingStreetSegments[0]].streetName))
+// Bidirectional A* over the edges of the routing graph
+// Forward label of edge e: travel time from the start up to the end of e (including e)
+// Backward label of edge e: travel time from the end of e to the destination (excluding e)
+// so a path through e costs forward + backward label, and turn penalties are applied exactly on both sides
+// Both searches use the average potential p(e) = (h(edge_to[e], dest) - h(start, edge_to[e])) / 2 (backward: -p),
+// which keeps both consistent, so the search can stop once the two smallest keys add up to the best path found
+std::pair<double, std::vector<StreetSegmentIdx>> findPathBidirectional (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty)
+{
+    std::vector<StreetSegmentIdx> result;
+    IntersectionIdx start_id = intersect_ids.first;
+    IntersectionIdx dest_id = intersect_ids.second;
+    if (start_id == dest_id)
+    {
+        return std::make_pair(0.0, result);
+    }
+
+    ensure_landmarks();
+    // Forward search in slot 0, backward search in slot 1 (parent: next edge towards the destination)
+    SearchWorkspace& forward = get_search_workspace(0);
+    SearchWorkspace& backward = get_search_workspace(1);
+    forward.start_search(Routing_Graph.edge_to.size());
+    backward.start_search(Routing_Graph.edge_to.size());
+    auto potential = [&](int edge)
+    {
+        IntersectionIdx id = Routing_Graph.edge_to[edge];
+        return (travel_time_lower_bound(id, dest_id) - travel_time_lower_bound(start_id, id)) / 2;
+    };
+
+    // Best path found so far, through meeting_edge
+    double best_time = std::numeric_limits<double>::infinity();
+    int meeting_edge = -1;
+    auto try_meeting = [&](int edge)
+    {
+        if (forward.has_label(edge) && backward.has_label(edge) && forward.g_value[edge] + backward.g_value[edge] < best_time)
+        {
+            best_time = forward.g_value[edge] + backward.g_value[edge];
+            meeting_edge = edge;
+        }
+    };
+
+    // Forward seeds: edges leaving the start intersection (no turn penalty)
+    for (int edge = Routing_Graph.offsets[start_id]; edge < Routing_Graph.offsets[start_id + 1]; edge++)
+    {
+        double g = Routing_Graph.edge_travel_time[edge];
+        if (!forward.has_label(edge) || g < forward.g_value[edge])
+        {
+            forward.set_label(edge, g, -1);
+            forward.push(g + potential(edge), edge);
+        }
+    }
+    // Backward seeds: edges entering the destination intersection
+    for (int i = Routing_Graph.in_offsets[dest_id]; i < Routing_Graph.in_offsets[dest_id + 1]; i++)
+    {
+        int edge = Routing_Graph.in_edges[i];
+        backward.set_label(edge, 0, -1);
+        backward.push(-potential(edge), edge);
+        try_meeting(edge);
+    }
+
+    while (!forward.heap.empty() && !backward.heap.empty())
+    {
+        // Neither search can improve on the best path anymore
+        if (forward.heap.front().first + backward.heap.front().first >= best_time)
+        {
+            break;
+        }
+
+        // Expand the direction with the smaller key
+        if (forward.heap.front().first <= backward.heap.front().first)
+        {
+            int current = forward.pop().second;
+            if (forward.is_settled(current))
             {
-                g += turn_penalty;
+                continue;
             }
-            // min_segment for neighbor = segment that leads to min g-value
-            StreetSegmentIdx min_segment = connectingStreetSegments[0];
-            
-            if (connectingStreetSegments.size() != 1)
+            forward.settle(current);
+
+            // Edges leaving the intersection reached, with the turn penalty from the current edge
+            IntersectionIdx intersection = Routing_Graph.edge_to[current];
+            StreetIdx current_street = Routing_Graph.edge_street[current];
+            for (int edge = Routing_Graph.offsets[intersection]; edge < Routing_Graph.offsets[intersection + 1]; edge++)
             {
-                for (StreetSegmentIdx streetSegment : connectingStreetSegments)
+                if (forward.is_settled(edge))
                 {
-                    // Calculate the g-value of the neighbor node, based on different street segments
-                    // Record the segment with shortest travel time
-                    double g_temp = current.g + Segment_SegmentDetailedInfo[streetSegment].travel_time;
-                    // Add turn_penalty if choosing the current streetsegment leads to a new street
-                    if ((current.parent_segment != -1) && 
-                        (Segment_SegmentDetailedInfo[current.parent_segment].streetName != Segment_SegmentDetailedInfo[streetSegment].streetName))
-                    {
-                        g_temp += turn_penalty;
-                    }
-                    // Update attirbutes for the neighbor node 
-                    if (g_temp < g)
-                    {
-                        g = g_temp;
-                        min_segment = streetSegment;
-                    }
+                    continue;
                 }
+                double g = forward.g_value[current] + turn_cost(current_street, Routing_Graph.edge_street[edge], turn_penalty);
+                g += Routing_Graph.edge_travel_time[edge];
+                if (!forward.has_label(edge) || g < forward.g_value[edge])
+                {
+                    forward.set_label(edge, g, current);
+                    forward.push(g + potential(edge), edge);
+                    try_meeting(edge);
+                }
+            }
+        } else
+        {
+            int current = backward.pop().second;
+            if (backward.is_settled(current))
+            {
+                continue;
             }
+            backward.settle(current);
 
-            // If the neighbor node has been recorded before, set g-value, parent, and parent_segment
-            // to the path with least travel time
-            if (record_node.find(pair.first) != record_node.end())
+            // Edges entering the intersection the current edge leaves from, with the turn penalty onto the current edge
+            IntersectionIdx intersection = Routing_Graph.edge_from[current];
+            StreetIdx current_street = Routing_Graph.edge_street[current];
+            for (int i = Routing_Graph.in_offsets[intersection]; i < Routing_Graph.in_offsets[intersection + 1]; i++)
             {
-                if (g < record_node[pair.first].g)
+                int edge = Routing_Graph.in_edges[i];
+                if (backward.is_settled(edge))
                 {
-                    record_node[pair.first].g = g;
-                    record_node[pair.first].parent = current.id;
-                    record_node[pair.first].parent_segment = min_segment;
-                    pq.push(record_node[pair.first]);
+                    continue;
+                }
+                double g = backward.g_value[current] + turn_cost(Routing_Graph.edge_street[edge], current_street, turn_penalty);
+                g += Routing_Graph.edge_travel_time[current];
+                if (!backward.has_label(edge) || g < backward.g_value[edge])
+                {
+                    backward.set_label(edge, g, current);
+                    backward.push(g - potential(edge), edge);
+                    try_meeting(edge);
                 }
-            } else
-            {
-                Node neighborNode = {pair.first, g, h, current.id, min_segment};
-                record_node[pair.first] = neighborNode;
-                pq.push(neighborNode);
             }
         }
     }
-    
-    return result;
-}
\ No newline at end of file
+
+    // No path exists
+    if (meeting_edge == -1)
+    {
+        return std::make_pair(0.0, result);
+    }
+
+    // Forward half: start --> meeting edge, then backward half: after the meeting edge --> destination
+    for (int edge = meeting_edge; edge != -1; edge = forward.parent[edge])
+    {
+        result.push_back(Routing_Graph.edge_segment[edge]);
+    }
+    std::reverse(result.begin(), result.end());
+    for (int edge = backward.parent[meeting_edge]; edge != -1; edge = backward.parent[edge])
+    {
+        result.push_back(Routing_Graph.edge_segment[edge]);
+    }
+    return std::make_pair(best_time, result);
+}
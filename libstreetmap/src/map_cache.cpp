@@ -0,0 +1,680 @@
+#include "map_cache.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+bool use_map_cache = true;
+std::string map_cache_directory;
+
+// Name of the program's directory in the user's cache directory
+const std::string USER_CACHE_NAME = "mapper";
+
+const char MAP_CACHE_MAGIC[8] = {'M', 'A', 'P', 'C', 'A', 'C', 'H', 'E'};
+
+// Sections of the file, each one array of a single record type
+enum MapCacheSection
+{
+    FEATURE_RECORDS,
+    SEGMENT_RECORDS,
+    SEGMENT_FROM,               // Plain arrays of Street_Segments, stored as they are
+    SEGMENT_TO,
+    SEGMENT_TRAVEL_TIME,
+    SEGMENT_STREET,
+    SEGMENT_ONE_WAY,
+    SEGMENT_BOUNDS,
+    SEGMENT_HIGHWAY_TYPE,
+    SEGMENT_LENGTH,
+    SEGMENT_WIDTH,
+    SEGMENT_FROM_XY,
+    SEGMENT_TO_XY,
+    SEGMENT_ANGLE,
+    INTERSECTION_RECORDS,
+    POINTS,                     // Feature points, segment curve points and polygon corners
+    INTERSECTION_SEGMENTS,      // Segments of each intersection
+    STRING_CHARS,
+    STRING_OFFSETS,             // String id --> first char (one more than the number of strings)
+    GRAPH_OFFSETS,
+    GRAPH_POSITIONS,
+    GRAPH_EDGE_FROM,
+    GRAPH_EDGE_TO,
+    GRAPH_EDGE_SEGMENT,
+    GRAPH_EDGE_TRAVEL_TIME,
+    GRAPH_EDGE_STREET,
+    GRAPH_IN_OFFSETS,
+    GRAPH_IN_EDGES,
+    SECTION_COUNT
+};
+
+// Size and modification time of a source database
+struct SourceStamp
+{
+    std::uint64_t size = 0;
+    std::int64_t modified = 0;
+};
+
+// Position (in bytes from the start of the file) and number of elements of a section
+struct SectionRange
+{
+    std::uint64_t offset = 0;
+    std::uint64_t count = 0;
+};
+
+struct MapCacheHeader
+{
+    char magic[sizeof(MAP_CACHE_MAGIC)];
+    std::uint32_t version;
+    std::uint32_t layout;       // Sum of the record sizes, catches a cache written by another build
+    SourceStamp streets, osm;
+    std::int32_t feature_count, segment_count, intersection_count, edge_count;
+    double lat_avg;
+    double world_top_right_x, world_top_right_y;
+    double world_bottom_left_x, world_bottom_left_y;
+    double max_speed_limit;
+    SectionRange sections[SECTION_COUNT];
+};
+
+// Features are stored in the order of Features_AllInfo (sorted by descending area)
+struct FeatureRecord
+{
+    std::int32_t id;
+    std::int32_t type;
+    std::int32_t osm_type;
+    std::uint32_t point_count;
+    std::uint64_t osm_id;
+    std::uint64_t first_point;
+    double area;
+    double max_lat, max_lon, min_lat, min_lon;
+};
+
+// Fields of Street_Segments that are not plain arrays: way OSM ID, strings and geometry
+struct SegmentRecord
+{
+    std::uint64_t way_osm_id;
+    std::uint32_t street_name, street_name_arrow;   // String ids
+    std::uint64_t first_point;          // Curve points, then POLY_CORNERS corners per polygon
+    std::uint32_t curve_point_count, polygon_count;
+};
+
+struct IntersectionRecord
+{
+    double x, y;
+    double lat, lon;
+    std::uint32_t name;                 // String id
+    std::uint32_t segment_count;
+    std::uint64_t first_segment;
+};
+
+// Strings of the cache, each stored once
+struct StringPool
+{
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<char> chars;
+    std::vector<std::uint64_t> offsets = {0};
+
+    std::uint32_t add (const std::string& value);
+};
+
+// mkdir -p, returns false if some directory of the path could not be created
+bool make_directories (const std::string& path);
+bool source_stamp (const std::string& filename, SourceStamp& stamp);
+std::uint32_t record_layout ();
+
+// Append the elements of values as one section of the file, 8-byte aligned
+template <typename T>
+void write_section (std::ofstream& file, MapCacheHeader& header, MapCacheSection section, const std::vector<T>& values);
+// Elements of a section of the mapped file (nullptr if it does not fit in the file or is misaligned)
+template <typename T>
+const T* read_section (const char* data, std::size_t size, const MapCacheHeader& header, MapCacheSection section);
+
+// Check every id and range the records refer to, before anything is filled from them
+bool records_are_valid (const char* data, std::size_t size, const MapCacheHeader& header);
+// Fill the structures from a mapped file whose header and records are valid
+void load_records (const char* data, std::size_t size, const MapCacheHeader& header);
+
+/*******************************************************************************************************************************
+ * MAP CACHE
+ ********************************************************************************************************************************/
+std::string user_cache_directory ()
+{
+    const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    std::string directory;
+    if (xdg_cache_home != nullptr && xdg_cache_home[0] == '/')
+    {
+        directory = std::string(xdg_cache_home) + "/" + USER_CACHE_NAME;
+    } else if (home != nullptr && home[0] != '\0')
+    {
+        directory = std::string(home) + "/.cache/" + USER_CACHE_NAME;
+    }
+    if (directory.empty() || !make_directories(directory))
+    {
+        return "";
+    }
+    return directory;
+}
+
+std::string map_cache_path (const std::string& map_streets_database_filename)
+{
+    const std::string suffix = ".streets.bin";
+    std::string path = map_streets_database_filename;
+    if (path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+        path.erase(path.size() - suffix.size());
+    }
+    std::string directory = map_cache_directory.empty() ? user_cache_directory() : map_cache_directory;
+    if (!directory.empty())
+    {
+        path = directory + "/" + path.substr(path.find_last_of('/') + 1);
+    }
+    return path + ".mapcache";
+}
+
+bool save_map_cache (const std::string& cache_filename,
+                     const std::string& map_streets_database_filename,
+                     const std::string& map_osm_database_filename)
+{
+    MapCacheHeader header = {};
+    std::memcpy(header.magic, MAP_CACHE_MAGIC, sizeof(MAP_CACHE_MAGIC));
+    header.version = MAP_CACHE_VERSION;
+    header.layout = record_layout();
+    if (!source_stamp(map_streets_database_filename, header.streets) || !source_stamp(map_osm_database_filename, header.osm))
+    {
+        return false;
+    }
+    header.feature_count = Features_AllInfo.size();
+    header.segment_count = Street_Segments.size();
+    header.intersection_count = Intersection_IntersectionInfo.size();
+    header.edge_count = Routing_Graph.edge_to.size();
+    header.lat_avg = lat_avg;
+    header.world_top_right_x = world_top_right.x;
+    header.world_top_right_y = world_top_right.y;
+    header.world_bottom_left_x = world_bottom_left.x;
+    header.world_bottom_left_y = world_bottom_left.y;
+    header.max_speed_limit = MAX_SPEED_LIMIT;
+
+    // Written to a temporary file first, so an interrupted write never leaves a truncated cache behind
+    std::string temp_filename = cache_filename + ".tmp";
+    std::ofstream file(temp_filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Flatten the structures: records refer to the point, segment and string pools by index
+    StringPool strings;
+    // Feature and segment geometry is copied out of Geometry_Points (subway tracks are not cached)
+    std::vector<ezgl::point2d> points;
+    points.reserve(Geometry_Points.size());
+    std::vector<FeatureRecord> features;
+    features.reserve(Features_AllInfo.size());
+    for (const FeatureDetailedInfo& feature : Features_AllInfo)
+    {
+        FeatureRecord record = {};
+        record.id = feature.id;
+        record.type = feature.featureType;
+        record.osm_type = feature.featureOSMID.type();
+        record.osm_id = static_cast<std::uint64_t>(feature.featureOSMID);
+        record.first_point = points.size();
+        record.point_count = feature.featurePoints.size();
+        record.area = feature.featureArea;
+        record.max_lat = feature.temp_max_lat;
+        record.max_lon = feature.temp_max_lon;
+        record.min_lat = feature.temp_min_lat;
+        record.min_lon = feature.temp_min_lon;
+        points.insert(points.end(), feature.featurePoints.begin(), feature.featurePoints.end());
+        features.push_back(record);
+    }
+
+    std::vector<SegmentRecord> segments(Street_Segments.size());
+    for (StreetSegmentIdx segment = 0; segment < Street_Segments.size(); segment++)
+    {
+        SegmentRecord& record = segments[segment];
+        record.way_osm_id = static_cast<std::uint64_t>(Street_Segments.way_osmid[segment]);
+        record.street_name = strings.add(Street_Segments.street_name[segment]);
+        record.street_name_arrow = strings.add(Street_Segments.street_name_arrow[segment]);
+        const GeometryRange& curve_points_xy = Street_Segments.curve_points_xy[segment];
+        const GeometryRange& poly_points = Street_Segments.poly_points[segment];
+        record.first_point = points.size();
+        record.curve_point_count = curve_points_xy.size();
+        record.polygon_count = poly_points.size() / POLY_CORNERS;
+        points.insert(points.end(), curve_points_xy.begin(), curve_points_xy.end());
+        points.insert(points.end(), poly_points.begin(), poly_points.end());
+    }
+
+    std::vector<IntersectionRecord> intersections;
+    std::vector<StreetSegmentIdx> intersection_segments;
+    intersections.reserve(Intersection_IntersectionInfo.size());
+    for (const IntersectionInfo& intersection : Intersection_IntersectionInfo)
+    {
+        IntersectionRecord record = {};
+        record.x = intersection.position_xy.x;
+        record.y = intersection.position_xy.y;
+        record.lat = intersection.position_latlon.latitude();
+        record.lon = intersection.position_latlon.longitude();
+        record.name = strings.add(intersection.name);
+        record.first_segment = intersection_segments.size();
+        record.segment_count = intersection.all_segments.size();
+        intersection_segments.insert(intersection_segments.end(), intersection.all_segments.begin(),
+                                     intersection.all_segments.end());
+        intersections.push_back(record);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(file, header, FEATURE_RECORDS, features);
+    write_section(file, header, SEGMENT_RECORDS, segments);
+    write_section(file, header, SEGMENT_FROM, Street_Segments.from);
+    write_section(file, header, SEGMENT_TO, Street_Segments.to);
+    write_section(file, header, SEGMENT_TRAVEL_TIME, Street_Segments.travel_time);
+    write_section(file, header, SEGMENT_STREET, Street_Segments.street);
+    write_section(file, header, SEGMENT_ONE_WAY, Street_Segments.one_way);
+    write_section(file, header, SEGMENT_BOUNDS, Street_Segments.bounds);
+    write_section(file, header, SEGMENT_HIGHWAY_TYPE, Street_Segments.highway_type);
+    write_section(file, header, SEGMENT_LENGTH, Street_Segments.length);
+    write_section(file, header, SEGMENT_WIDTH, Street_Segments.width);
+    write_section(file, header, SEGMENT_FROM_XY, Street_Segments.from_xy);
+    write_section(file, header, SEGMENT_TO_XY, Street_Segments.to_xy);
+    write_section(file, header, SEGMENT_ANGLE, Street_Segments.angle_degree);
+    write_section(file, header, INTERSECTION_RECORDS, intersections);
+    write_section(file, header, POINTS, points);
+    write_section(file, header, INTERSECTION_SEGMENTS, intersection_segments);
+    write_section(file, header, STRING_CHARS, strings.chars);
+    write_section(file, header, STRING_OFFSETS, strings.offsets);
+    write_section(file, header, GRAPH_OFFSETS, Routing_Graph.offsets);
+    write_section(file, header, GRAPH_POSITIONS, Routing_Graph.position_latlon);
+    write_section(file, header, GRAPH_EDGE_FROM, Routing_Graph.edge_from);
+    write_section(file, header, GRAPH_EDGE_TO, Routing_Graph.edge_to);
+    write_section(file, header, GRAPH_EDGE_SEGMENT, Routing_Graph.edge_segment);
+    write_section(file, header, GRAPH_EDGE_TRAVEL_TIME, Routing_Graph.edge_travel_time);
+    write_section(file, header, GRAPH_EDGE_STREET, Routing_Graph.edge_street);
+    write_section(file, header, GRAPH_IN_OFFSETS, Routing_Graph.in_offsets);
+    write_section(file, header, GRAPH_IN_EDGES, Routing_Graph.in_edges);
+    // Header again, now that the section ranges are known
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    if (!file || std::rename(temp_filename.c_str(), cache_filename.c_str()) != 0)
+    {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool load_map_cache (const std::string& cache_filename,
+                     const std::string& map_streets_database_filename,
+                     const std::string& map_osm_database_filename)
+{
+    SourceStamp streets, osm;
+    if (!source_stamp(map_streets_database_filename, streets) || !source_stamp(map_osm_database_filename, osm))
+    {
+        return false;
+    }
+
+    int fd = open(cache_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size >= (off_t) sizeof(MapCacheHeader))
+    {
+        mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    const char* data = static_cast<const char*>(mapping);
+    std::size_t size = file_stat.st_size;
+
+    // The cache must have been written by this build, from the same databases, for the map currently loaded
+    MapCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    bool valid = std::memcmp(header.magic, MAP_CACHE_MAGIC, sizeof(MAP_CACHE_MAGIC)) == 0
+                 && header.version == MAP_CACHE_VERSION && header.layout == record_layout()
+                 && header.streets.size == streets.size && header.streets.modified == streets.modified
+                 && header.osm.size == osm.size && header.osm.modified == osm.modified
+                 && header.feature_count == getNumFeatures() && header.segment_count == getNumStreetSegments()
+                 && header.intersection_count == getNumIntersections()
+                 && records_are_valid(data, size, header);
+    if (valid)
+    {
+        load_records(data, size, header);
+    }
+    munmap(mapping, size);
+    return valid;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+std::uint32_t StringPool::add (const std::string& value)
+{
+    auto inserted = ids.insert(std::make_pair(value, (std::uint32_t) ids.size()));
+    if (inserted.second)
+    {
+        chars.insert(chars.end(), value.begin(), value.end());
+        offsets.push_back(chars.size());
+    }
+    return inserted.first->second;
+}
+
+bool make_directories (const std::string& path)
+{
+    for (std::size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+    {
+        std::string prefix = path.substr(0, slash);
+        if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            return false;
+        }
+        if (slash == std::string::npos)
+        {
+            return true;
+        }
+    }
+}
+
+bool source_stamp (const std::string& filename, SourceStamp& stamp)
+{
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) != 0)
+    {
+        return false;
+    }
+    stamp.size = file_stat.st_size;
+    stamp.modified = file_stat.st_mtime;
+    return true;
+}
+
+std::uint32_t record_layout ()
+{
+    return sizeof(MapCacheHeader) + sizeof(FeatureRecord) + sizeof(SegmentRecord) + sizeof(IntersectionRecord)
+           + sizeof(ezgl::point2d) + sizeof(LatLon) + sizeof(StreetSegmentIdx) + sizeof(IntersectionIdx) + sizeof(StreetIdx)
+           + sizeof(ezgl::rectangle) + sizeof(HighwayType);
+}
+
+template <typename T>
+void write_section (std::ofstream& file, MapCacheHeader& header, MapCacheSection section, const std::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "map cache sections are copied byte for byte");
+    const char padding[8] = {};
+    std::uint64_t offset = file.tellp();
+    file.write(padding, (8 - offset % 8) % 8);
+    header.sections[section].offset = file.tellp();
+    header.sections[section].count = values.size();
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+const T* read_section (const char* data, std::size_t size, const MapCacheHeader& header, MapCacheSection section)
+{
+    const SectionRange& range = header.sections[section];
+    if (range.offset % alignof(T) != 0 || range.offset > size || range.count > (size - range.offset) / sizeof(T))
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(data + range.offset);
+}
+
+bool records_are_valid (const char* data, std::size_t size, const MapCacheHeader& header)
+{
+    const SectionRange* sections = header.sections;
+    // Every section must lie within the file
+    if (!read_section<FeatureRecord>(data, size, header, FEATURE_RECORDS)
+        || !read_section<SegmentRecord>(data, size, header, SEGMENT_RECORDS)
+        || !read_section<IntersectionIdx>(data, size, header, SEGMENT_FROM)
+        || !read_section<IntersectionIdx>(data, size, header, SEGMENT_TO)
+        || !read_section<double>(data, size, header, SEGMENT_TRAVEL_TIME)
+        || !read_section<StreetIdx>(data, size, header, SEGMENT_STREET)
+        || !read_section<char>(data, size, header, SEGMENT_ONE_WAY)
+        || !read_section<ezgl::rectangle>(data, size, header, SEGMENT_BOUNDS)
+        || !read_section<HighwayType>(data, size, header, SEGMENT_HIGHWAY_TYPE)
+        || !read_section<double>(data, size, header, SEGMENT_LENGTH)
+        || !read_section<int>(data, size, header, SEGMENT_WIDTH)
+        || !read_section<ezgl::point2d>(data, size, header, SEGMENT_FROM_XY)
+        || !read_section<ezgl::point2d>(data, size, header, SEGMENT_TO_XY)
+        || !read_section<double>(data, size, header, SEGMENT_ANGLE)
+        || !read_section<IntersectionRecord>(data, size, header, INTERSECTION_RECORDS)
+        || !read_section<ezgl::point2d>(data, size, header, POINTS)
+        || !read_section<StreetSegmentIdx>(data, size, header, INTERSECTION_SEGMENTS)
+        || !read_section<char>(data, size, header, STRING_CHARS)
+        || !read_section<std::uint64_t>(data, size, header, STRING_OFFSETS)
+        || !read_section<int>(data, size, header, GRAPH_OFFSETS)
+        || !read_section<LatLon>(data, size, header, GRAPH_POSITIONS)
+        || !read_section<IntersectionIdx>(data, size, header, GRAPH_EDGE_FROM)
+        || !read_section<IntersectionIdx>(data, size, header, GRAPH_EDGE_TO)
+        || !read_section<StreetSegmentIdx>(data, size, header, GRAPH_EDGE_SEGMENT)
+        || !read_section<double>(data, size, header, GRAPH_EDGE_TRAVEL_TIME)
+        || !read_section<StreetIdx>(data, size, header, GRAPH_EDGE_STREET)
+        || !read_section<int>(data, size, header, GRAPH_IN_OFFSETS)
+        || !read_section<int>(data, size, header, GRAPH_IN_EDGES))
+    {
+        return false;
+    }
+
+    // Record counts must match the map, and the routing graph arrays its number of intersections and edges
+    std::uint64_t edges = header.edge_count;
+    std::uint64_t offsets = header.intersection_count + 1;
+    for (int section = SEGMENT_RECORDS; section <= SEGMENT_ANGLE; section++)
+    {
+        if (sections[section].count != (std::uint64_t) header.segment_count)
+        {
+            return false;
+        }
+    }
+    if (sections[FEATURE_RECORDS].count != (std::uint64_t) header.feature_count
+        || sections[INTERSECTION_RECORDS].count != (std::uint64_t) header.intersection_count
+        || sections[STRING_OFFSETS].count == 0 || sections[GRAPH_OFFSETS].count != offsets
+        || sections[GRAPH_POSITIONS].count != offsets - 1 || sections[GRAPH_IN_OFFSETS].count != offsets
+        || sections[GRAPH_EDGE_FROM].count != edges || sections[GRAPH_EDGE_TO].count != edges
+        || sections[GRAPH_EDGE_SEGMENT].count != edges || sections[GRAPH_EDGE_TRAVEL_TIME].count != edges
+        || sections[GRAPH_EDGE_STREET].count != edges || sections[GRAPH_IN_EDGES].count != edges)
+    {
+        return false;
+    }
+
+    // Strings must lie within the char pool, records within the string, point and segment pools
+    std::uint64_t string_count = sections[STRING_OFFSETS].count - 1;
+    const std::uint64_t* string_offsets = read_section<std::uint64_t>(data, size, header, STRING_OFFSETS);
+    for (std::uint64_t id = 0; id < string_count; id++)
+    {
+        if (string_offsets[id] > string_offsets[id + 1] || string_offsets[id + 1] > sections[STRING_CHARS].count)
+        {
+            return false;
+        }
+    }
+    auto fits = [](std::uint64_t first, std::uint64_t count, std::uint64_t pool_size)
+    {
+        return first <= pool_size && count <= pool_size - first;
+    };
+    std::uint64_t point_count = sections[POINTS].count;
+    const FeatureRecord* features = read_section<FeatureRecord>(data, size, header, FEATURE_RECORDS);
+    for (int i = 0; i < header.feature_count; i++)
+    {
+        if (!fits(features[i].first_point, features[i].point_count, point_count))
+        {
+            return false;
+        }
+    }
+    const SegmentRecord* segments = read_section<SegmentRecord>(data, size, header, SEGMENT_RECORDS);
+    const HighwayType* highway_types = read_section<HighwayType>(data, size, header, SEGMENT_HIGHWAY_TYPE);
+    for (int i = 0; i < header.segment_count; i++)
+    {
+        // Highway types index the draw tables
+        const SegmentRecord& record = segments[i];
+        if (record.street_name >= string_count || record.street_name_arrow >= string_count
+            || highway_types[i] >= NUM_HIGHWAY_TYPES
+            || !fits(record.first_point, record.curve_point_count + (std::uint64_t) POLY_CORNERS * record.polygon_count,
+                     point_count))
+        {
+            return false;
+        }
+    }
+    const IntersectionRecord* intersections = read_section<IntersectionRecord>(data, size, header, INTERSECTION_RECORDS);
+    for (int i = 0; i < header.intersection_count; i++)
+    {
+        if (intersections[i].name >= string_count
+            || !fits(intersections[i].first_segment, intersections[i].segment_count, sections[INTERSECTION_SEGMENTS].count))
+        {
+            return false;
+        }
+    }
+
+    // Ids in the plain arrays must index the map, and the adjacency offsets must be monotonic
+    std::uint64_t segment_count = header.segment_count;
+    std::uint64_t intersection_count = header.intersection_count;
+    std::uint64_t street_count = getNumStreets();
+    auto ids_fit = [&](auto section, std::uint64_t count, std::uint64_t id_count)
+    {
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            if (section[i] < 0 || (std::uint64_t) section[i] >= id_count)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto offsets_fit = [&](const int* section)
+    {
+        for (std::uint64_t i = 0; i + 1 < offsets; i++)
+        {
+            if (section[i] > section[i + 1])
+            {
+                return false;
+            }
+        }
+        return section[0] == 0 && (std::uint64_t) section[offsets - 1] == edges;
+    };
+    return ids_fit(read_section<IntersectionIdx>(data, size, header, SEGMENT_FROM), segment_count, intersection_count)
+        && ids_fit(read_section<IntersectionIdx>(data, size, header, SEGMENT_TO), segment_count, intersection_count)
+        && ids_fit(read_section<StreetIdx>(data, size, header, SEGMENT_STREET), segment_count, street_count)
+        && ids_fit(read_section<StreetSegmentIdx>(data, size, header, INTERSECTION_SEGMENTS),
+                   sections[INTERSECTION_SEGMENTS].count, segment_count)
+        && ids_fit(read_section<IntersectionIdx>(data, size, header, GRAPH_EDGE_FROM), edges, intersection_count)
+        && ids_fit(read_section<IntersectionIdx>(data, size, header, GRAPH_EDGE_TO), edges, intersection_count)
+        && ids_fit(read_section<StreetSegmentIdx>(data, size, header, GRAPH_EDGE_SEGMENT), edges, segment_count)
+        && ids_fit(read_section<StreetIdx>(data, size, header, GRAPH_EDGE_STREET), edges, street_count)
+        && ids_fit(read_section<int>(data, size, header, GRAPH_IN_EDGES), edges, edges)
+        && offsets_fit(read_section<int>(data, size, header, GRAPH_OFFSETS))
+        && offsets_fit(read_section<int>(data, size, header, GRAPH_IN_OFFSETS));
+}
+
+void load_records (const char* data, std::size_t size, const MapCacheHeader& header)
+{
+    const ezgl::point2d* points = read_section<ezgl::point2d>(data, size, header, POINTS);
+    const char* chars = read_section<char>(data, size, header, STRING_CHARS);
+    const std::uint64_t* string_offsets = read_section<std::uint64_t>(data, size, header, STRING_OFFSETS);
+    auto string_at = [&](std::uint32_t id)
+    {
+        return std::string(chars + string_offsets[id], string_offsets[id + 1] - string_offsets[id]);
+    };
+
+    lat_avg = header.lat_avg;
+    world_top_right = ezgl::point2d(header.world_top_right_x, header.world_top_right_y);
+    world_bottom_left = ezgl::point2d(header.world_bottom_left_x, header.world_bottom_left_y);
+    world_height = world_top_right.y - world_bottom_left.y;
+    grid_height = world_height / NUM_GRIDS;
+    world_width = world_top_right.x - world_bottom_left.x;
+    grid_width = world_width / NUM_GRIDS;
+    MAX_SPEED_LIMIT = header.max_speed_limit;
+
+    // The point pool becomes (the start of) Geometry_Points in one copy: records only hold offsets into it
+    std::size_t first_point = Geometry_Points.size();
+    Geometry_Points.insert(Geometry_Points.end(), points, points + header.sections[POINTS].count);
+
+    // Records are independent: each one fills its own struct
+    const FeatureRecord* features = read_section<FeatureRecord>(data, size, header, FEATURE_RECORDS);
+    Features_AllInfo.resize(header.feature_count);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < header.feature_count; i++)
+    {
+        const FeatureRecord& record = features[i];
+        FeatureDetailedInfo& feature = Features_AllInfo[i];
+        feature.id = record.id;
+        feature.featureType = static_cast<FeatureType>(record.type);
+        feature.featureOSMID = TypedOSMID(static_cast<TypedOSMID::EntityType>(record.osm_type), OSMID(record.osm_id));
+        feature.featurePoints = {first_point + record.first_point, record.point_count};
+        feature.featureArea = record.area;
+        feature.temp_max_lat = record.max_lat;
+        feature.temp_max_lon = record.max_lon;
+        feature.temp_min_lat = record.min_lat;
+        feature.temp_min_lon = record.min_lon;
+    }
+
+    // Plain arrays are copied as they are
+    auto copy_section = [&](auto& values, MapCacheSection section)
+    {
+        using T = typename std::remove_reference<decltype(values)>::type::value_type;
+        const T* first = read_section<T>(data, size, header, section);
+        values.assign(first, first + header.sections[section].count);
+    };
+    Street_Segments.resize(header.segment_count);
+    copy_section(Street_Segments.from, SEGMENT_FROM);
+    copy_section(Street_Segments.to, SEGMENT_TO);
+    copy_section(Street_Segments.travel_time, SEGMENT_TRAVEL_TIME);
+    copy_section(Street_Segments.street, SEGMENT_STREET);
+    copy_section(Street_Segments.one_way, SEGMENT_ONE_WAY);
+    copy_section(Street_Segments.bounds, SEGMENT_BOUNDS);
+    copy_section(Street_Segments.highway_type, SEGMENT_HIGHWAY_TYPE);
+    copy_section(Street_Segments.length, SEGMENT_LENGTH);
+    copy_section(Street_Segments.width, SEGMENT_WIDTH);
+    copy_section(Street_Segments.from_xy, SEGMENT_FROM_XY);
+    copy_section(Street_Segments.to_xy, SEGMENT_TO_XY);
+    copy_section(Street_Segments.angle_degree, SEGMENT_ANGLE);
+
+    const SegmentRecord* segments = read_section<SegmentRecord>(data, size, header, SEGMENT_RECORDS);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (StreetSegmentIdx segment = 0; segment < header.segment_count; segment++)
+    {
+        const SegmentRecord& record = segments[segment];
+        Street_Segments.way_osmid[segment] = OSMID(record.way_osm_id);
+        Street_Segments.street_name[segment] = string_at(record.street_name);
+        Street_Segments.street_name_arrow[segment] = string_at(record.street_name_arrow);
+        std::size_t first = first_point + record.first_point;
+        Street_Segments.curve_points_xy[segment] = {first, record.curve_point_count};
+        Street_Segments.poly_points[segment] = {first + record.curve_point_count,
+                                                (std::size_t) record.polygon_count * POLY_CORNERS};
+    }
+
+    const IntersectionRecord* intersections = read_section<IntersectionRecord>(data, size, header, INTERSECTION_RECORDS);
+    const StreetSegmentIdx* intersection_segments = read_section<StreetSegmentIdx>(data, size, header, INTERSECTION_SEGMENTS);
+    Intersection_IntersectionInfo.resize(header.intersection_count);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < header.intersection_count; i++)
+    {
+        const IntersectionRecord& record = intersections[i];
+        IntersectionInfo& intersection = Intersection_IntersectionInfo[i];
+        intersection.position_xy = ezgl::point2d(record.x, record.y);
+        intersection.position_latlon = LatLon(record.lat, record.lon);
+        intersection.name = string_at(record.name);
+        intersection.all_segments.assign(intersection_segments + record.first_segment,
+                                         intersection_segments + record.first_segment + record.segment_count);
+    }
+
+    // Routing graph arrays too
+    copy_section(Routing_Graph.offsets, GRAPH_OFFSETS);
+    copy_section(Routing_Graph.position_latlon, GRAPH_POSITIONS);
+    copy_section(Routing_Graph.edge_from, GRAPH_EDGE_FROM);
+    copy_section(Routing_Graph.edge_to, GRAPH_EDGE_TO);
+    copy_section(Routing_Graph.edge_segment, GRAPH_EDGE_SEGMENT);
+    copy_section(Routing_Graph.edge_travel_time, GRAPH_EDGE_TRAVEL_TIME);
+    copy_section(Routing_Graph.edge_street, GRAPH_EDGE_STREET);
+    copy_section(Routing_Graph.in_offsets, GRAPH_IN_OFFSETS);
+    copy_section(Routing_Graph.in_edges, GRAPH_IN_EDGES);
+}
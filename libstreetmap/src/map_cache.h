@@ -0,0 +1,57 @@
+/************************************************************
+ * PREPROCESSED MAP CACHE (.mapcache)
+ *
+ * Binary snapshot of what m1_init derives from the .streets.bin and
+ * .osm.bin databases: features (points, areas, sorted order), street
+ * segments (geometry, polygons, names, angles), intersections and the
+ * routing graph, plus the city bounds and MAX_SPEED_LIMIT.
+ * - Written to the user's cache directory (or map_cache_directory) after
+ *   a load that computed them: the map directories may be read-only
+ *   (/cad2) or shared
+ * - Later loads map the file into memory (mmap) and fill the same
+ *   structures from its flat arrays instead of querying the databases
+ * - All records are fixed-size, strings live in one deduplicated pool and
+ *   geometry in one point pool, referenced by index (position independent)
+ * - Ignored if the version, record layout or the size / modification time
+ *   of either database differs from what the cache was written from
+ * The grids and name maps are rebuilt from the loaded structures by m1_init.
+ ************************************************************/
+
+#ifndef MAP_CACHE_H
+#define MAP_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include "m1.h"
+#include "globals.h"
+
+// Bumped whenever the file layout, or the way m1_init computes the cached structures, changes
+const std::uint32_t MAP_CACHE_VERSION = 3;
+
+// Whether m1_init loads the map cache (and writes it when missing or stale)
+extern bool use_map_cache;
+
+// Directory the cache files are kept in (empty: user_cache_directory())
+extern std::string map_cache_directory;
+
+// Per-user cache directory of the program, created if missing: $XDG_CACHE_HOME/mapper, else $HOME/.cache/mapper
+// Empty if neither variable is set or the directory cannot be created
+std::string user_cache_directory ();
+
+// <map>.mapcache in map_cache_directory, else in user_cache_directory(), else next to the <map>.streets.bin file
+// Maps with the same name share a file: the source stamps tell which one it was written from
+std::string map_cache_path (const std::string& map_streets_database_filename);
+
+// Write the structures m1_init computed for the loaded map, returns false if the file could not be written
+bool save_map_cache (const std::string& cache_filename,
+                     const std::string& map_streets_database_filename,
+                     const std::string& map_osm_database_filename);
+
+// Fill Features_AllInfo, Street_Segments, Intersection_IntersectionInfo, Routing_Graph,
+// the city bounds and MAX_SPEED_LIMIT from the cache (geometry is appended to Geometry_Points)
+// Returns false (and leaves them untouched) if the file is missing, stale or corrupt
+bool load_map_cache (const std::string& cache_filename,
+                     const std::string& map_streets_database_filename,
+                     const std::string& map_osm_database_filename);
+
+#endif /* MAP_CACHE_H */
@@ -0,0 +1,591 @@
+#include "routing/contraction_hierarchy.hpp"
+#include "routing/routing.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <queue>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+ContractionHierarchy Contraction_Hierarchy;
+bool build_contraction_hierarchy_on_load = false;
+
+// Witness searches are local: they only follow paths of up to WITNESS_HOP_LIMIT edges, and settle at most
+// WITNESS_SETTLES_PER_EDGE states per edge of an average remaining state (within the min / max limits)
+// The graph gets denser as it is contracted, so later searches may settle more states
+// A missed witness only costs an extra shortcut, never a wrong travel time
+// Priority updates of the neighbors of a contracted state only estimate, they use the smallest limit
+const int WITNESS_HOP_LIMIT = 6;
+const int WITNESS_SETTLES_PER_EDGE = 8;
+const int WITNESS_MIN_SETTLE_LIMIT = 40;
+const int WITNESS_MAX_SETTLE_LIMIT = 400;
+
+// Neighbors of a state during contraction: (neighbor state, edge id) pairs, cheapest edge per neighbor
+typedef std::vector<std::pair<int, int>> NeighborEdges;
+
+// Dijkstra from source over uncontracted states, avoiding skip_state, until all targets are settled
+// or max_cost / the hop and settle limits are reached
+void witness_search (int source, int skip_state, double max_cost, int settle_limit,
+                     const NeighborEdges& targets,
+                     const std::vector<std::vector<int>>& out_lists,
+                     const std::vector<char>& contracted,
+                     SearchWorkspace& workspace);
+
+// Shortcuts (from, to, weight, child_first, child_second) needed if 'state' is contracted now
+std::vector<CHEdge> find_shortcuts (int state, int settle_limit,
+                                    const std::vector<std::vector<int>>& out_lists,
+                                    const std::vector<std::vector<int>>& in_lists,
+                                    const std::vector<char>& contracted,
+                                    SearchWorkspace& workspace);
+
+// Contraction priority: edge difference (shortcuts added - edges removed) plus number of contracted neighbors
+int contraction_priority (int state, int shortcuts,
+                          const std::vector<std::vector<int>>& out_lists,
+                          const std::vector<std::vector<int>>& in_lists,
+                          const std::vector<char>& contracted,
+                          const std::vector<int>& deleted_neighbors);
+
+// Stall-on-demand: whether the upward search reached state more cheaply through a higher ranked state
+// (over an edge pointing down to it, which the search itself never takes). Such a state cannot be on a
+// shortest up-down path, so its edges need not be relaxed
+bool is_stalled (int state, bool forward, const SearchWorkspace& search);
+
+/*******************************************************************************************************************************
+ * PREPROCESSING
+ ********************************************************************************************************************************/
+void build_contraction_hierarchy (double turn_penalty)
+{
+    clear_contraction_hierarchy();
+    int stateNum = Routing_Graph.edge_to.size();
+    std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+
+    // Original edges: every legal turn from a routing graph edge onto an edge leaving its target intersection
+    std::vector<std::vector<int>> out_lists(stateNum);
+    std::vector<std::vector<int>> in_lists(stateNum);
+    for (int state = 0; state < stateNum; state++)
+    {
+        IntersectionIdx intersection = Routing_Graph.edge_to[state];
+        for (int next = Routing_Graph.offsets[intersection]; next < Routing_Graph.offsets[intersection + 1]; next++)
+        {
+            if (next == state)
+            {
+                continue;
+            }
+            double weight = turn_cost(Routing_Graph.edge_street[state], Routing_Graph.edge_street[next], turn_penalty);
+            weight += Routing_Graph.edge_travel_time[next];
+            out_lists[state].push_back(edges.size());
+            in_lists[next].push_back(edges.size());
+            edges.push_back({state, next, weight, -1, -1});
+        }
+    }
+
+    // Priority of a state: simulated contraction (independent for each state --> one workspace per OpenMP thread)
+    // level (depth of the hierarchy below the state) spreads contraction evenly over the map
+    std::vector<char> contracted(stateNum, 0);
+    std::vector<int> deleted_neighbors(stateNum, 0);
+    std::vector<int> level(stateNum, 0);
+    std::vector<int> priority(stateNum);
+    long long remaining_edges = edges.size();
+    int remaining_states = stateNum;
+    auto settle_limit = [&]()
+    {
+        long long limit = WITNESS_SETTLES_PER_EDGE * remaining_edges / std::max(remaining_states, 1);
+        return (int) std::min<long long>(std::max<long long>(limit, WITNESS_MIN_SETTLE_LIMIT), WITNESS_MAX_SETTLE_LIMIT);
+    };
+    auto state_priority = [&](int state, int limit, SearchWorkspace& workspace)
+    {
+        int shortcuts = find_shortcuts(state, limit, out_lists, in_lists, contracted, workspace).size();
+        return contraction_priority(state, shortcuts, out_lists, in_lists, contracted, deleted_neighbors) + level[state];
+    };
+    int initial_limit = settle_limit();
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int state = 0; state < stateNum; state++)
+    {
+        priority[state] = state_priority(state, initial_limit, get_search_workspace());
+    }
+
+    // Entries whose priority is no longer the state's current priority are stale and skipped
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
+    for (int state = 0; state < stateNum; state++)
+    {
+        pq.push(std::make_pair(priority[state], state));
+    }
+
+    // Contract states in priority order: the priorities of the neighbors of a contracted state are updated right away,
+    // any other change is caught lazily (re-evaluated when the state reaches the top of the queue)
+    SearchWorkspace& workspace = get_search_workspace();
+    Contraction_Hierarchy.rank.assign(stateNum, 0);
+    int order = 0;
+    std::vector<int> neighbors;
+    while (!pq.empty())
+    {
+        std::pair<int, int> top = pq.top();
+        pq.pop();
+        int state = top.second;
+        if (contracted[state] || top.first != priority[state])
+        {
+            continue;
+        }
+        int limit = settle_limit();
+        std::vector<CHEdge> shortcuts = find_shortcuts(state, limit, out_lists, in_lists, contracted, workspace);
+        int new_priority = contraction_priority(state, shortcuts.size(), out_lists, in_lists, contracted, deleted_neighbors) + level[state];
+        if (!pq.empty() && new_priority > pq.top().first)
+        {
+            priority[state] = new_priority;
+            pq.push(std::make_pair(new_priority, state));
+            continue;
+        }
+
+        // Add shortcuts, or lower the weight of an existing edge between the same states
+        for (const CHEdge& shortcut : shortcuts)
+        {
+            bool found = false;
+            for (int edge_id : out_lists[shortcut.from])
+            {
+                if (edges[edge_id].to == shortcut.to)
+                {
+                    if (shortcut.weight < edges[edge_id].weight)
+                    {
+                        edges[edge_id] = shortcut;
+                    }
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                out_lists[shortcut.from].push_back(edges.size());
+                in_lists[shortcut.to].push_back(edges.size());
+                edges.push_back(shortcut);
+                remaining_edges++;
+            }
+        }
+
+        // Remove the contracted state from the lists of its neighbors (its own edges stay in 'edges')
+        contracted[state] = 1;
+        Contraction_Hierarchy.rank[state] = order++;
+        remaining_states--;
+        remaining_edges -= out_lists[state].size() + in_lists[state].size();
+        auto remove_edge = [](std::vector<int>& edge_list, int edge_id)
+        {
+            auto it = std::find(edge_list.begin(), edge_list.end(), edge_id);
+            if (it != edge_list.end())
+            {
+                *it = edge_list.back();
+                edge_list.pop_back();
+            }
+        };
+        neighbors.clear();
+        for (int edge_id : out_lists[state])
+        {
+            int neighbor = edges[edge_id].to;
+            deleted_neighbors[neighbor]++;
+            level[neighbor] = std::max(level[neighbor], level[state] + 1);
+            remove_edge(in_lists[neighbor], edge_id);
+            neighbors.push_back(neighbor);
+        }
+        for (int edge_id : in_lists[state])
+        {
+            int neighbor = edges[edge_id].from;
+            deleted_neighbors[neighbor]++;
+            level[neighbor] = std::max(level[neighbor], level[state] + 1);
+            remove_edge(out_lists[neighbor], edge_id);
+            neighbors.push_back(neighbor);
+        }
+        out_lists[state].clear();
+        in_lists[state].clear();
+
+        // Neighbor priorities only depend on the (now fixed) lists --> simulated in parallel
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        #pragma omp parallel for schedule(dynamic, 1) if (neighbors.size() > 8)
+        for (int i = 0; i < (int) neighbors.size(); i++)
+        {
+            priority[neighbors[i]] = state_priority(neighbors[i], WITNESS_MIN_SETTLE_LIMIT, get_search_workspace());
+        }
+        for (int neighbor : neighbors)
+        {
+            pq.push(std::make_pair(priority[neighbor], neighbor));
+        }
+    }
+
+    // Split edges into the upward graph (forward search) and the reversed upward graph (backward search)
+    const std::vector<int>& rank = Contraction_Hierarchy.rank;
+    Contraction_Hierarchy.up_offsets.assign(stateNum + 1, 0);
+    Contraction_Hierarchy.down_offsets.assign(stateNum + 1, 0);
+    for (const CHEdge& edge : edges)
+    {
+        if (rank[edge.to] > rank[edge.from])
+        {
+            Contraction_Hierarchy.up_offsets[edge.from + 1]++;
+        } else if (rank[edge.to] < rank[edge.from])
+        {
+            Contraction_Hierarchy.down_offsets[edge.to + 1]++;
+        }
+    }
+    for (int state = 0; state < stateNum; state++)
+    {
+        Contraction_Hierarchy.up_offsets[state + 1] += Contraction_Hierarchy.up_offsets[state];
+        Contraction_Hierarchy.down_offsets[state + 1] += Contraction_Hierarchy.down_offsets[state];
+    }
+    Contraction_Hierarchy.up_edges.resize(Contraction_Hierarchy.up_offsets[stateNum]);
+    Contraction_Hierarchy.down_edges.resize(Contraction_Hierarchy.down_offsets[stateNum]);
+    std::vector<int> up_position(Contraction_Hierarchy.up_offsets.begin(), Contraction_Hierarchy.up_offsets.end() - 1);
+    std::vector<int> down_position(Contraction_Hierarchy.down_offsets.begin(), Contraction_Hierarchy.down_offsets.end() - 1);
+    for (int edge_id = 0; edge_id < edges.size(); edge_id++)
+    {
+        const CHEdge& edge = edges[edge_id];
+        if (rank[edge.to] > rank[edge.from])
+        {
+            Contraction_Hierarchy.up_edges[up_position[edge.from]++] = edge_id;
+        } else if (rank[edge.to] < rank[edge.from])
+        {
+            Contraction_Hierarchy.down_edges[down_position[edge.to]++] = edge_id;
+        }
+    }
+
+    Contraction_Hierarchy.turn_penalty = turn_penalty;
+}
+
+void clear_contraction_hierarchy ()
+{
+    Contraction_Hierarchy.turn_penalty = -1;
+    Contraction_Hierarchy.rank.clear();
+    Contraction_Hierarchy.edges.clear();
+    Contraction_Hierarchy.up_offsets.clear();
+    Contraction_Hierarchy.up_edges.clear();
+    Contraction_Hierarchy.down_offsets.clear();
+    Contraction_Hierarchy.down_edges.clear();
+}
+
+void ensure_contraction_hierarchy (double turn_penalty)
+{
+    if (!contraction_hierarchy_ready(turn_penalty))
+    {
+        build_contraction_hierarchy(turn_penalty);
+    }
+}
+
+bool contraction_hierarchy_ready (double turn_penalty)
+{
+    return Contraction_Hierarchy.turn_penalty >= 0 && Contraction_Hierarchy.turn_penalty == turn_penalty;
+}
+
+/*******************************************************************************************************************************
+ * QUERY
+ ********************************************************************************************************************************/
+std::pair<double, std::vector<StreetSegmentIdx>> findPathContractionHierarchy (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty)
+{
+    if (!contraction_hierarchy_ready(turn_penalty))
+    {
+        return findPathEdgeBased(intersect_ids, turn_penalty);
+    }
+
+    std::vector<StreetSegmentIdx> result;
+    IntersectionIdx start_id = intersect_ids.first;
+    IntersectionIdx dest_id = intersect_ids.second;
+    if (start_id == dest_id)
+    {
+        return std::make_pair(0.0, result);
+    }
+
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    int stateNum = Routing_Graph.edge_to.size();
+    SearchWorkspace& forward = get_search_workspace(0);
+    SearchWorkspace& backward = get_search_workspace(1);
+    forward.start_search(stateNum);
+    backward.start_search(stateNum);
+
+    // Forward search starts on the edges leaving start_id, backward search on the edges entering dest_id
+    for (int edge = Routing_Graph.offsets[start_id]; edge < Routing_Graph.offsets[start_id + 1]; edge++)
+    {
+        forward.set_label(edge, Routing_Graph.edge_travel_time[edge], -1);
+        forward.push(Routing_Graph.edge_travel_time[edge], edge);
+    }
+    for (int i = Routing_Graph.in_offsets[dest_id]; i < Routing_Graph.in_offsets[dest_id + 1]; i++)
+    {
+        int edge = Routing_Graph.in_edges[i];
+        backward.set_label(edge, 0, -1);
+        backward.push(0, edge);
+    }
+
+    // Both searches only go up the hierarchy, and meet at the highest ranked state of the shortest path
+    double best_time = DBL_MAX;
+    int meeting_state = -1;
+    while (true)
+    {
+        bool forward_open = !forward.heap.empty() && forward.heap.front().first < best_time;
+        bool backward_open = !backward.heap.empty() && backward.heap.front().first < best_time;
+        if (!forward_open && !backward_open)
+        {
+            break;
+        }
+        // Expand the direction with the smaller key
+        bool expand_forward = forward_open && (!backward_open || forward.heap.front().first <= backward.heap.front().first);
+        SearchWorkspace& search = expand_forward ? forward : backward;
+        SearchWorkspace& other = expand_forward ? backward : forward;
+
+        int state = search.pop().second;
+        if (search.is_settled(state))
+        {
+            continue;
+        }
+        search.settle(state);
+        if (other.has_label(state) && search.g_value[state] + other.g_value[state] < best_time)
+        {
+            best_time = search.g_value[state] + other.g_value[state];
+            meeting_state = state;
+        }
+        if (is_stalled(state, expand_forward, search))
+        {
+            continue;
+        }
+
+        if (expand_forward)
+        {
+            for (int i = Contraction_Hierarchy.up_offsets[state]; i < Contraction_Hierarchy.up_offsets[state + 1]; i++)
+            {
+                const CHEdge& edge = edges[Contraction_Hierarchy.up_edges[i]];
+                double g = search.g_value[state] + edge.weight;
+                if (!search.has_label(edge.to) || g < search.g_value[edge.to])
+                {
+                    search.set_label(edge.to, g, Contraction_Hierarchy.up_edges[i]);
+                    search.push(g, edge.to);
+                }
+            }
+        } else
+        {
+            for (int i = Contraction_Hierarchy.down_offsets[state]; i < Contraction_Hierarchy.down_offsets[state + 1]; i++)
+            {
+                const CHEdge& edge = edges[Contraction_Hierarchy.down_edges[i]];
+                double g = search.g_value[state] + edge.weight;
+                if (!search.has_label(edge.from) || g < search.g_value[edge.from])
+                {
+                    search.set_label(edge.from, g, Contraction_Hierarchy.down_edges[i]);
+                    search.push(g, edge.from);
+                }
+            }
+        }
+    }
+
+    // No path exists
+    if (meeting_state == -1)
+    {
+        return std::make_pair(0.0, result);
+    }
+
+    // Forward half: hierarchy edges from the first state up to the meeting state
+    std::vector<int> forward_edges;
+    int first_state = meeting_state;
+    while (forward.parent[first_state] != -1)
+    {
+        forward_edges.push_back(forward.parent[first_state]);
+        first_state = edges[forward.parent[first_state]].from;
+    }
+    std::reverse(forward_edges.begin(), forward_edges.end());
+
+    // Unpack shortcuts into routing graph edges, then into street segments
+    std::vector<int> states = {first_state};
+    for (int edge_id : forward_edges)
+    {
+        unpack_ch_edge(edge_id, states);
+    }
+    // Backward half: hierarchy edges from the meeting state down to an edge entering dest_id
+    for (int state = meeting_state; backward.parent[state] != -1; state = edges[backward.parent[state]].to)
+    {
+        unpack_ch_edge(backward.parent[state], states);
+    }
+
+    result.reserve(states.size());
+    for (int state : states)
+    {
+        result.push_back(Routing_Graph.edge_segment[state]);
+    }
+    return std::make_pair(best_time, result);
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+void witness_search (int source, int skip_state, double max_cost, int settle_limit,
+                     const NeighborEdges& targets,
+                     const std::vector<std::vector<int>>& out_lists,
+                     const std::vector<char>& contracted,
+                     SearchWorkspace& workspace)
+{
+    // Witness paths are never rebuilt: the parent of a label holds its number of hops from the source instead
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    workspace.start_search(contracted.size());
+    workspace.set_label(source, 0, 0);
+    workspace.push(0, source);
+    int settled = 0;
+    int targets_left = targets.size();
+    while (!workspace.heap.empty() && settled < settle_limit && targets_left > 0)
+    {
+        std::pair<double, int> top = workspace.pop();
+        if (top.first > max_cost)
+        {
+            break;
+        }
+        int state = top.second;
+        if (workspace.is_settled(state))
+        {
+            continue;
+        }
+        workspace.settle(state);
+        settled++;
+        for (const auto& target : targets)
+        {
+            targets_left -= (target.first == state);
+        }
+        int hops = workspace.parent[state] + 1;
+        if (hops > WITNESS_HOP_LIMIT)
+        {
+            continue;
+        }
+        for (int edge_id : out_lists[state])
+        {
+            int next = edges[edge_id].to;
+            if (next == skip_state || contracted[next])
+            {
+                continue;
+            }
+            double g = workspace.g_value[state] + edges[edge_id].weight;
+            if (!workspace.has_label(next) || g < workspace.g_value[next])
+            {
+                workspace.set_label(next, g, hops);
+                workspace.push(g, next);
+            }
+        }
+    }
+}
+
+std::vector<CHEdge> find_shortcuts (int state, int settle_limit,
+                                    const std::vector<std::vector<int>>& out_lists,
+                                    const std::vector<std::vector<int>>& in_lists,
+                                    const std::vector<char>& contracted,
+                                    SearchWorkspace& workspace)
+{
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    std::vector<CHEdge> shortcuts;
+
+    // Cheapest edge from / to each uncontracted neighbor
+    auto collect = [&](const std::vector<int>& edge_list, bool incoming)
+    {
+        NeighborEdges neighbors;
+        for (int edge_id : edge_list)
+        {
+            int neighbor = incoming ? edges[edge_id].from : edges[edge_id].to;
+            if (contracted[neighbor] || neighbor == state)
+            {
+                continue;
+            }
+            auto it = std::find_if(neighbors.begin(), neighbors.end(),
+                                   [&](const std::pair<int, int>& n) { return n.first == neighbor; });
+            if (it == neighbors.end())
+            {
+                neighbors.push_back(std::make_pair(neighbor, edge_id));
+            } else if (edges[edge_id].weight < edges[it->second].weight)
+            {
+                it->second = edge_id;
+            }
+        }
+        return neighbors;
+    };
+    NeighborEdges in_neighbors = collect(in_lists[state], true);
+    NeighborEdges out_neighbors = collect(out_lists[state], false);
+    if (in_neighbors.empty() || out_neighbors.empty())
+    {
+        return shortcuts;
+    }
+
+    double max_out = 0;
+    for (const auto& out : out_neighbors)
+    {
+        max_out = std::max(max_out, edges[out.second].weight);
+    }
+
+    // A shortcut u -> w is needed unless a witness path u -> w avoiding 'state' is at most as long
+    for (const auto& in : in_neighbors)
+    {
+        double in_weight = edges[in.second].weight;
+        witness_search(in.first, state, in_weight + max_out, settle_limit, out_neighbors, out_lists, contracted, workspace);
+        for (const auto& out : out_neighbors)
+        {
+            if (out.first == in.first)
+            {
+                continue;
+            }
+            double via_weight = in_weight + edges[out.second].weight;
+            if (workspace.has_label(out.first) && workspace.g_value[out.first] <= via_weight)
+            {
+                continue;
+            }
+            shortcuts.push_back({in.first, out.first, via_weight, in.second, out.second});
+        }
+    }
+    return shortcuts;
+}
+
+int contraction_priority (int state, int shortcuts,
+                          const std::vector<std::vector<int>>& out_lists,
+                          const std::vector<std::vector<int>>& in_lists,
+                          const std::vector<char>& contracted,
+                          const std::vector<int>& deleted_neighbors)
+{
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    int removed_edges = 0;
+    for (int edge_id : out_lists[state])
+    {
+        removed_edges += !contracted[edges[edge_id].to];
+    }
+    for (int edge_id : in_lists[state])
+    {
+        removed_edges += !contracted[edges[edge_id].from];
+    }
+    return shortcuts - removed_edges + deleted_neighbors[state];
+}
+
+bool is_stalled (int state, bool forward, const SearchWorkspace& search)
+{
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    double g_state = search.g_value[state];
+    if (forward)
+    {
+        // Edges from higher ranked states down to state
+        for (int i = Contraction_Hierarchy.down_offsets[state]; i < Contraction_Hierarchy.down_offsets[state + 1]; i++)
+        {
+            const CHEdge& edge = edges[Contraction_Hierarchy.down_edges[i]];
+            if (search.has_label(edge.from) && search.g_value[edge.from] + edge.weight < g_state)
+            {
+                return true;
+            }
+        }
+    } else
+    {
+        // Edges from state up to higher ranked states
+        for (int i = Contraction_Hierarchy.up_offsets[state]; i < Contraction_Hierarchy.up_offsets[state + 1]; i++)
+        {
+            const CHEdge& edge = edges[Contraction_Hierarchy.up_edges[i]];
+            if (search.has_label(edge.to) && search.g_value[edge.to] + edge.weight < g_state)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void unpack_ch_edge (int edge_id, std::vector<int>& states)
+{
+    const CHEdge& edge = Contraction_Hierarchy.edges[edge_id];
+    if (edge.child_first == -1)
+    {
+        states.push_back(edge.to);
+        return;
+    }
+    unpack_ch_edge(edge.child_first, states);
+    unpack_ch_edge(edge.child_second, states);
+}
@@ -0,0 +1,65 @@
+/************************************************************
+ * CONTRACTION HIERARCHIES
+ *
+ * Optional speed-up index for point-to-point path queries.
+ * Built on the edge-based (turn-aware) graph: a state is a routing graph edge,
+ * and moving from one edge to the next costs the turn cost plus the travel time
+ * of the next edge. The index is therefore exact for the one turn penalty it
+ * was built with; queries with any other penalty fall back to edge-based A*.
+ * Not used by findPathBetweenIntersections: bench_path_queries must first show
+ * a query speedup over edge-based A* on Toronto that pays for the build.
+ ************************************************************/
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "m1.h"
+#include "globals.h"
+
+// An edge of the hierarchy between two states (routing graph edges)
+// Original edges (a turn from edge 'from' onto edge 'to') have no children
+// Shortcuts replace the path child_first + child_second through a contracted state
+struct CHEdge
+{
+    int from;
+    int to;
+    double weight;
+    int child_first;    // -1 for original edges
+    int child_second;   // -1 for original edges
+};
+
+struct ContractionHierarchy
+{
+    double turn_penalty = -1;       // Turn penalty the index was built for (< 0: not built)
+    std::vector<int> rank;          // Index: state, Value: contraction order
+    std::vector<CHEdge> edges;      // Original edges and shortcuts
+    // Upward edges leaving each state (forward search): up_edges[up_offsets[state] .. up_offsets[state + 1])
+    std::vector<int> up_offsets;
+    std::vector<int> up_edges;
+    // Upward edges entering each state (backward search): down_edges[down_offsets[state] .. down_offsets[state + 1])
+    std::vector<int> down_offsets;
+    std::vector<int> down_edges;
+};
+extern ContractionHierarchy Contraction_Hierarchy;
+
+// Whether m1_init should build the hierarchy (for DEFAULT_TURN_PENALTY) after loading a map
+extern bool build_contraction_hierarchy_on_load;
+
+// Contract all states of the routing graph for the given turn penalty (replaces any previous index)
+void build_contraction_hierarchy (double turn_penalty);
+void clear_contraction_hierarchy ();
+// Build the hierarchy for this turn penalty unless it already exists
+void ensure_contraction_hierarchy (double turn_penalty);
+// Whether a hierarchy exists for this turn penalty
+bool contraction_hierarchy_ready (double turn_penalty);
+
+// Append the routing graph edges (states) that hierarchy edge edge_id stands for, excluding its 'from' state
+void unpack_ch_edge (int edge_id, std::vector<int>& states);
+
+// Bidirectional upward search on the hierarchy, with shortcuts unpacked back into street segments
+// Falls back to edge-based A* if no hierarchy was built for this turn penalty
+std::pair<double, std::vector<StreetSegmentIdx>> findPathContractionHierarchy (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty);
+
+#endif /* CONTRACTION_HIERARCHY_H */
@@ -0,0 +1,174 @@
+#include "routing/landmarks.hpp"
+#include "routing/routing.hpp"
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+Landmarks ALT_Landmarks;
+int NUM_LANDMARKS = 16;
+
+// Set once init_landmarks has run (even with no landmark), reset by clear_landmarks
+std::atomic<bool> landmarks_ready(false);
+std::mutex landmarks_lock;
+
+// Plain Dijkstra (travel time only, no turn penalties) from source over the routing graph, or over the
+// reverse adjacency if backward. times[id]: travel time of every intersection (infinity if not reached)
+void landmark_dijkstra (IntersectionIdx source, bool backward, std::vector<double>& times);
+
+/*******************************************************************************************************************************
+ * PREPROCESSING
+ ********************************************************************************************************************************/
+void init_landmarks (int num_landmarks)
+{
+    clear_landmarks();
+    int intersection_count = Routing_Graph.offsets.size() - 1;
+    if (num_landmarks <= 0 || intersection_count == 0)
+    {
+        landmarks_ready = true;
+        return;
+    }
+
+    // Only intersections reachable from the middle of the map are candidates,
+    // so that landmarks are not picked on small disconnected pieces of road
+    double center_lat = 0, center_lon = 0;
+    for (const LatLon& position : Routing_Graph.position_latlon)
+    {
+        center_lat += position.latitude() / intersection_count;
+        center_lon += position.longitude() / intersection_count;
+    }
+    double lon_scale = std::cos(center_lat * kDegreeToRadian);
+    auto offset_from_center = [&](IntersectionIdx id)
+    {
+        return std::make_pair((Routing_Graph.position_latlon[id].longitude() - center_lon) * lon_scale,
+                              Routing_Graph.position_latlon[id].latitude() - center_lat);
+    };
+    IntersectionIdx center_id = 0;
+    double best_distance = std::numeric_limits<double>::infinity();
+    for (IntersectionIdx id = 0; id < intersection_count; id++)
+    {
+        auto [x, y] = offset_from_center(id);
+        if (Routing_Graph.offsets[id + 1] > Routing_Graph.offsets[id] && x * x + y * y < best_distance)
+        {
+            best_distance = x * x + y * y;
+            center_id = id;
+        }
+    }
+    std::vector<double> reached_from_center(intersection_count);
+    landmark_dijkstra(center_id, false, reached_from_center);
+
+    // Split the map into num_landmarks angular sectors around the center, and pick the
+    // candidate furthest from the center in each (landmarks "behind" the destination give tight bounds)
+    std::vector<IntersectionIdx> furthest(num_landmarks, -1);
+    std::vector<double> furthest_distance(num_landmarks, -1);
+    for (IntersectionIdx id = 0; id < intersection_count; id++)
+    {
+        if (std::isinf(reached_from_center[id]))
+        {
+            continue;
+        }
+        auto [x, y] = offset_from_center(id);
+        int sector = std::min(num_landmarks - 1, (int) ((std::atan2(y, x) + M_PI) / (2 * M_PI) * num_landmarks));
+        if (x * x + y * y > furthest_distance[sector])
+        {
+            furthest_distance[sector] = x * x + y * y;
+            furthest[sector] = id;
+        }
+    }
+    for (IntersectionIdx id : furthest)
+    {
+        if (id != -1)
+        {
+            ALT_Landmarks.ids.push_back(id);
+        }
+    }
+
+    // One forward and one backward Dijkstra per landmark, all independent --> run in parallel
+    // Each task fills its own landmark-major row (threads never share a cache line), transposed afterwards
+    // so that the bounds of one intersection are contiguous
+    int count = ALT_Landmarks.ids.size();
+    std::vector<std::vector<double>> rows(2 * count);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int task = 0; task < 2 * count; task++)
+    {
+        rows[task].resize(intersection_count);
+        landmark_dijkstra(ALT_Landmarks.ids[task / 2], task % 2, rows[task]);
+    }
+    ALT_Landmarks.from_landmark.resize(intersection_count * count);
+    ALT_Landmarks.to_landmark.resize(intersection_count * count);
+    #pragma omp parallel for
+    for (IntersectionIdx id = 0; id < intersection_count; id++)
+    {
+        for (int k = 0; k < count; k++)
+        {
+            ALT_Landmarks.from_landmark[id * count + k] = rows[2 * k][id];
+            ALT_Landmarks.to_landmark[id * count + k] = rows[2 * k + 1][id];
+        }
+    }
+    ALT_Landmarks.count = count;
+    landmarks_ready = true;
+}
+
+void clear_landmarks ()
+{
+    landmarks_ready = false;
+    ALT_Landmarks.count = 0;
+    ALT_Landmarks.ids.clear();
+    ALT_Landmarks.from_landmark.clear();
+    ALT_Landmarks.to_landmark.clear();
+}
+
+void ensure_landmarks ()
+{
+    if (!landmarks_ready)
+    {
+        std::lock_guard<std::mutex> guard(landmarks_lock);
+        if (!landmarks_ready)
+        {
+            init_landmarks(NUM_LANDMARKS);
+        }
+    }
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+void landmark_dijkstra (IntersectionIdx source, bool backward, std::vector<double>& times)
+{
+    int intersection_count = Routing_Graph.offsets.size() - 1;
+    SearchWorkspace& workspace = get_search_workspace();
+    workspace.start_search(intersection_count);
+    workspace.set_label(source, 0, -1);
+    workspace.push(0, source);
+    while (!workspace.heap.empty())
+    {
+        IntersectionIdx current = workspace.pop().second;
+        if (workspace.is_settled(current))
+        {
+            continue;
+        }
+        workspace.settle(current);
+
+        const std::vector<int>& offsets = backward ? Routing_Graph.in_offsets : Routing_Graph.offsets;
+        for (int i = offsets[current]; i < offsets[current + 1]; i++)
+        {
+            // Backward: follow edges entering current, towards the intersection they leave from
+            int edge = backward ? Routing_Graph.in_edges[i] : i;
+            IntersectionIdx neighbor = backward ? Routing_Graph.edge_from[edge] : Routing_Graph.edge_to[edge];
+            double g = workspace.g_value[current] + Routing_Graph.edge_travel_time[edge];
+            if (!workspace.is_settled(neighbor) && (!workspace.has_label(neighbor) || g < workspace.g_value[neighbor]))
+            {
+                workspace.set_label(neighbor, g, current);
+                workspace.push(g, neighbor);
+            }
+        }
+    }
+
+    for (IntersectionIdx id = 0; id < intersection_count; id++)
+    {
+        times[id] = workspace.is_settled(id) ? workspace.g_value[id] : std::numeric_limits<double>::infinity();
+    }
+}
@@ -0,0 +1,61 @@
+/************************************************************
+ * ALT LANDMARKS (A*, Landmarks, Triangle inequality)
+ *
+ * Travel times (without turn penalties) from and to a few landmark
+ * intersections give lower bounds on the travel time between any two
+ * intersections:
+ *     d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+ * Turn penalties only add time, so the bounds hold for any turn penalty.
+ * Computed on the first search that needs them (ensure_landmarks), not
+ * by loadMap: 2 Dijkstras per landmark over the whole map.
+ ************************************************************/
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <algorithm>
+#include "m1.h"
+#include "globals.h"
+
+struct Landmarks
+{
+    int count = 0;                              // Number of landmarks (0: ALT disabled)
+    std::vector<IntersectionIdx> ids;           // Landmark intersections
+    // Index: intersection id * count + landmark, Value: travel time (infinity if unreachable)
+    // Doubles, like the search labels: rounded (float) times would make the bounds inconsistent, which
+    // the settled-node skips and stopping rules of the searches do not allow
+    std::vector<double> from_landmark;          // d(landmark, intersection)
+    std::vector<double> to_landmark;            // d(intersection, landmark)
+};
+extern Landmarks ALT_Landmarks;
+
+// Number of landmarks ensure_landmarks computes (0 disables ALT, A* then uses the straight-line heuristic)
+extern int NUM_LANDMARKS;
+
+// Pick num_landmarks intersections around the edge of the map and compute travel times from and to each
+void init_landmarks (int num_landmarks);
+// Forget the landmarks: the next ensure_landmarks computes them again
+void clear_landmarks ();
+// init_landmarks(NUM_LANDMARKS) unless landmarks were computed since the last clear_landmarks
+// Thread safe: concurrent callers wait for the first one to finish
+void ensure_landmarks ();
+
+// Lower bound on the travel time from one intersection to another (max over all landmark bounds)
+inline double landmark_lower_bound (IntersectionIdx from, IntersectionIdx to)
+{
+    int count = ALT_Landmarks.count;
+    const double* from_v = &ALT_Landmarks.from_landmark[from * count];
+    const double* from_t = &ALT_Landmarks.from_landmark[to * count];
+    const double* to_v = &ALT_Landmarks.to_landmark[from * count];
+    const double* to_t = &ALT_Landmarks.to_landmark[to * count];
+    double bound = 0;
+    // Differences of two infinities are NaN, which std::max ignores (bound stays first argument)
+    for (int k = 0; k < count; k++)
+    {
+        bound = std::max(bound, from_t[k] - from_v[k]);
+        bound = std::max(bound, to_v[k] - to_t[k]);
+    }
+    return bound;
+}
+
+#endif /* LANDMARKS_H */
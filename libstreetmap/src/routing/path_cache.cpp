@@ -0,0 +1,397 @@
+#include "routing/path_cache.hpp"
+#include "map_cache.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+long long PATH_CACHE_CAPACITY = 1 << 19;
+bool use_path_cache_file = true;
+std::string path_cache_file;
+
+// First bytes of a cache file, bumped whenever the layout changes
+const char PATH_CACHE_MAGIC[8] = {'P', 'A', 'T', 'H', 'C', 'A', 'C', '1'};
+
+struct PathCacheKey
+{
+    IntersectionIdx source;
+    IntersectionIdx target;
+    double turn_penalty;
+
+    bool operator== (const PathCacheKey& other) const
+    {
+        return source == other.source && target == other.target && turn_penalty == other.turn_penalty;
+    }
+};
+
+struct PathCacheKeyHash
+{
+    std::size_t operator() (const PathCacheKey& key) const
+    {
+        std::uint64_t penalty_bits;
+        std::memcpy(&penalty_bits, &key.turn_penalty, sizeof(penalty_bits));
+        std::uint64_t hash = ((std::uint64_t) (std::uint32_t) key.source << 32) | (std::uint32_t) key.target;
+        hash ^= penalty_bits + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        return std::hash<std::uint64_t>()(hash);
+    }
+};
+
+struct PathCacheEntry
+{
+    PathCacheKey key;
+    float cost;
+    bool has_segments;
+    std::vector<StreetSegmentIdx> segments;
+};
+
+struct PathCache
+{
+    std::string map_path;                   // Map the entries were computed on
+    std::list<PathCacheEntry> entries;      // Most recently used first
+    std::unordered_map<PathCacheKey, std::list<PathCacheEntry>::iterator, PathCacheKeyHash> index;
+    PathCacheStats stats;
+    std::mutex lock;
+};
+PathCache Path_Cache;
+
+// Entry of the key moved to the front (nullptr if not cached). Caller holds the lock
+PathCacheEntry* find_entry (const PathCacheKey& key);
+
+// Entry of the key (created if needed) moved to the front, least recently used entries evicted. Caller holds the lock
+PathCacheEntry& insert_entry (const PathCacheKey& key, float cost);
+
+// Drop all entries if they were computed on another map than the current one. Caller holds the lock
+void check_current_map ();
+
+/*******************************************************************************************************************************
+ * LOOKUP & INSERTION
+ ********************************************************************************************************************************/
+bool path_cache_lookup (IntersectionIdx source, IntersectionIdx target, double turn_penalty,
+                        float& cost, std::vector<StreetSegmentIdx>* segments)
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    check_current_map();
+    PathCacheEntry* entry = find_entry({source, target, turn_penalty});
+    if (entry == nullptr || (segments != nullptr && !entry->has_segments))
+    {
+        Path_Cache.stats.misses++;
+        return false;
+    }
+    Path_Cache.stats.hits++;
+    cost = entry->cost;
+    if (segments != nullptr)
+    {
+        *segments = entry->segments;
+    }
+    return true;
+}
+
+void path_cache_insert (IntersectionIdx source, IntersectionIdx target, double turn_penalty, float cost)
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    check_current_map();
+    insert_entry({source, target, turn_penalty}, cost);
+}
+
+void path_cache_insert (IntersectionIdx source, IntersectionIdx target, double turn_penalty, float cost,
+                        const std::vector<StreetSegmentIdx>& segments)
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    check_current_map();
+    PathCacheEntry& entry = insert_entry({source, target, turn_penalty}, cost);
+    entry.has_segments = true;
+    entry.segments = segments;
+}
+
+void clear_path_cache ()
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    Path_Cache.entries.clear();
+    Path_Cache.index.clear();
+    Path_Cache.map_path = CURRENT_MAP_PATH;
+    Path_Cache.stats.entries = 0;
+}
+
+std::string path_cache_map_path ()
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    return Path_Cache.map_path;
+}
+
+PathCacheStats path_cache_stats ()
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    return Path_Cache.stats;
+}
+
+void reset_path_cache_stats ()
+{
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    long long entries = Path_Cache.stats.entries;
+    Path_Cache.stats = PathCacheStats();
+    Path_Cache.stats.entries = entries;
+}
+
+/*******************************************************************************************************************************
+ * TRAVEL TIME MATRIX
+ ********************************************************************************************************************************/
+TravelTimeMatrix cached_travel_time_matrix (const std::vector<IntersectionIdx>& points, double turn_penalty)
+{
+    if (PATH_CACHE_CAPACITY <= 0)
+    {
+        return compute_travel_time_matrix(points, points, turn_penalty);
+    }
+
+    // Rows with every cost cached are taken from the cache, the others are searched again (a whole
+    // one-to-many search costs about the same as a partial one). Hits and misses are counted per entry
+    int n = points.size();
+    TravelTimeMatrix matrix;
+    matrix.turn_penalty = turn_penalty;
+    matrix.sources = points;
+    matrix.targets = points;
+    matrix.costs.assign(n * n, FLT_MAX);
+    std::vector<IntersectionIdx> missing_points;
+    std::vector<int> missing_rows;
+    {
+        std::lock_guard<std::mutex> guard(Path_Cache.lock);
+        check_current_map();
+        for (int s = 0; s < n; s++)
+        {
+            bool complete = true;
+            for (int t = 0; t < n; t++)
+            {
+                PathCacheEntry* entry = find_entry({points[s], points[t], turn_penalty});
+                if (entry == nullptr)
+                {
+                    complete = false;
+                    Path_Cache.stats.misses++;
+                } else
+                {
+                    matrix.costs[s * n + t] = entry->cost;
+                    Path_Cache.stats.hits++;
+                }
+            }
+            if (!complete)
+            {
+                missing_points.push_back(points[s]);
+                missing_rows.push_back(s);
+            }
+        }
+    }
+    if (missing_rows.empty())
+    {
+        return matrix;
+    }
+
+    // Nothing cached: the searched matrix keeps its search trees to rebuild paths
+    // Otherwise paths are rebuilt by point-to-point queries (see TravelTimeMatrix::path)
+    TravelTimeMatrix searched = compute_travel_time_matrix(missing_points, points, turn_penalty);
+    if (missing_rows.size() == n)
+    {
+        matrix = std::move(searched);
+    } else
+    {
+        for (int row = 0; row < missing_rows.size(); row++)
+        {
+            std::copy(searched.costs.begin() + row * n, searched.costs.begin() + (row + 1) * n,
+                      matrix.costs.begin() + missing_rows[row] * n);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    for (int s : missing_rows)
+    {
+        for (int t = 0; t < n; t++)
+        {
+            insert_entry({points[s], points[t], turn_penalty}, matrix.costs[s * n + t]);
+        }
+    }
+    return matrix;
+}
+
+std::vector<StreetSegmentIdx> cached_path (const TravelTimeMatrix& matrix, int source, int target)
+{
+    float cost;
+    std::vector<StreetSegmentIdx> segments;
+    if (PATH_CACHE_CAPACITY > 0
+        && path_cache_lookup(matrix.sources[source], matrix.targets[target], matrix.turn_penalty, cost, &segments))
+    {
+        return segments;
+    }
+    segments = matrix.path(source, target);
+    if (PATH_CACHE_CAPACITY > 0)
+    {
+        path_cache_insert(matrix.sources[source], matrix.targets[target], matrix.turn_penalty,
+                          matrix.cost(source, target), segments);
+    }
+    return segments;
+}
+
+/*******************************************************************************************************************************
+ * FILE
+ ********************************************************************************************************************************/
+std::string path_cache_path (const std::string& map_streets_database_filename)
+{
+    const std::string suffix = ".mapcache";
+    std::string path = map_cache_path(map_streets_database_filename);
+    return path.substr(0, path.size() - suffix.size()) + ".pathcache";
+}
+
+// Layout (native byte order): magic, map path length and characters, intersection and street segment counts,
+// entry count, then per entry (least recently used first): source, target, turn penalty, cost, segment count
+// (-1 if no segments stored) and segments
+bool save_path_cache (const std::string& filename)
+{
+    // No check_current_map: when switching cities, the entries of the old map are saved before they are cleared
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+    auto write = [&](const void* data, std::size_t size)
+    {
+        file.write(static_cast<const char*>(data), size);
+    };
+
+    write(PATH_CACHE_MAGIC, sizeof(PATH_CACHE_MAGIC));
+    std::uint32_t path_length = Path_Cache.map_path.size();
+    write(&path_length, sizeof(path_length));
+    write(Path_Cache.map_path.data(), path_length);
+    std::int32_t intersection_count = getNumIntersections();
+    std::int32_t segment_count = getNumStreetSegments();
+    write(&intersection_count, sizeof(intersection_count));
+    write(&segment_count, sizeof(segment_count));
+    std::uint64_t entry_count = Path_Cache.entries.size();
+    write(&entry_count, sizeof(entry_count));
+    for (auto it = Path_Cache.entries.rbegin(); it != Path_Cache.entries.rend(); it++)
+    {
+        std::int32_t segment_num = it->has_segments ? (std::int32_t) it->segments.size() : -1;
+        write(&it->key.source, sizeof(it->key.source));
+        write(&it->key.target, sizeof(it->key.target));
+        write(&it->key.turn_penalty, sizeof(it->key.turn_penalty));
+        write(&it->cost, sizeof(it->cost));
+        write(&segment_num, sizeof(segment_num));
+        write(it->segments.data(), it->segments.size() * sizeof(StreetSegmentIdx));
+    }
+    return static_cast<bool>(file);
+}
+
+bool load_path_cache (const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    auto read = [&](void* data, std::size_t size)
+    {
+        return static_cast<bool>(file.read(static_cast<char*>(data), size));
+    };
+
+    // Header must match the current map
+    char magic[sizeof(PATH_CACHE_MAGIC)];
+    std::uint32_t path_length;
+    if (!read(magic, sizeof(magic)) || std::memcmp(magic, PATH_CACHE_MAGIC, sizeof(magic)) != 0
+        || !read(&path_length, sizeof(path_length)))
+    {
+        return false;
+    }
+    std::string map_path(path_length, '\0');
+    std::int32_t intersection_count, segment_count;
+    std::uint64_t entry_count;
+    if (!read(&map_path[0], path_length) || !read(&intersection_count, sizeof(intersection_count))
+        || !read(&segment_count, sizeof(segment_count)) || !read(&entry_count, sizeof(entry_count))
+        || map_path != CURRENT_MAP_PATH || intersection_count != getNumIntersections()
+        || segment_count != getNumStreetSegments())
+    {
+        return false;
+    }
+
+    // Entries are read into a temporary list: a truncated or corrupt file adds none of them
+    std::vector<PathCacheEntry> loaded;
+    for (std::uint64_t i = 0; i < entry_count; i++)
+    {
+        PathCacheEntry entry = {};
+        std::int32_t segment_num;
+        if (!read(&entry.key.source, sizeof(entry.key.source)) || !read(&entry.key.target, sizeof(entry.key.target))
+            || !read(&entry.key.turn_penalty, sizeof(entry.key.turn_penalty)) || !read(&entry.cost, sizeof(entry.cost))
+            || !read(&segment_num, sizeof(segment_num)) || segment_num < -1)
+        {
+            return false;
+        }
+        if (segment_num >= 0)
+        {
+            entry.segments.resize(segment_num);
+            if (!read(entry.segments.data(), segment_num * sizeof(StreetSegmentIdx)))
+            {
+                return false;
+            }
+            entry.has_segments = true;
+        }
+        loaded.push_back(std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> guard(Path_Cache.lock);
+    check_current_map();
+    for (PathCacheEntry& entry : loaded)
+    {
+        PathCacheEntry& inserted = insert_entry(entry.key, entry.cost);
+        if (entry.has_segments)
+        {
+            inserted.has_segments = true;
+            inserted.segments = std::move(entry.segments);
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+PathCacheEntry* find_entry (const PathCacheKey& key)
+{
+    auto it = Path_Cache.index.find(key);
+    if (it == Path_Cache.index.end())
+    {
+        return nullptr;
+    }
+    Path_Cache.entries.splice(Path_Cache.entries.begin(), Path_Cache.entries, it->second);
+    return &*it->second;
+}
+
+PathCacheEntry& insert_entry (const PathCacheKey& key, float cost)
+{
+    PathCacheEntry* existing = find_entry(key);
+    if (existing != nullptr)
+    {
+        existing->cost = cost;
+        return *existing;
+    }
+    Path_Cache.entries.push_front({key, cost, false, {}});
+    Path_Cache.index[key] = Path_Cache.entries.begin();
+    while (Path_Cache.entries.size() > PATH_CACHE_CAPACITY && Path_Cache.entries.size() > 1)
+    {
+        Path_Cache.index.erase(Path_Cache.entries.back().key);
+        Path_Cache.entries.pop_back();
+        Path_Cache.stats.evictions++;
+    }
+    Path_Cache.stats.entries = Path_Cache.entries.size();
+    return Path_Cache.entries.front();
+}
+
+void check_current_map ()
+{
+    if (Path_Cache.map_path != CURRENT_MAP_PATH)
+    {
+        Path_Cache.entries.clear();
+        Path_Cache.index.clear();
+        Path_Cache.map_path = CURRENT_MAP_PATH;
+        Path_Cache.stats.entries = 0;
+    }
+}
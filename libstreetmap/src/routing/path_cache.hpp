@@ -0,0 +1,75 @@
+/************************************************************
+ * PATH CACHE
+ *
+ * Travel times (and, for the legs actually driven, street segments)
+ * between intersections, keyed by (source, target, turn penalty).
+ * travelingCourier calls on the same map keep asking for the same
+ * depots and delivery hotspots: matrix rows whose costs are all
+ * cached are not searched again.
+ * - Least recently used entries are evicted past PATH_CACHE_CAPACITY
+ * - Cleared by loadMap / closeMap (and whenever the current map changes)
+ * - Saved by closeMap to a file next to the map cache, loaded back by
+ *   loadMap (use_path_cache_file)
+ * All functions are thread safe.
+ ************************************************************/
+
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <string>
+#include "m1.h"
+#include "globals.h"
+#include "routing/travel_time_matrix.hpp"
+
+struct PathCacheStats
+{
+    long long hits = 0;         // Lookups answered from the cache
+    long long misses = 0;       // Lookups that needed a search
+    long long evictions = 0;
+    long long entries = 0;      // Current number of entries
+
+    double hit_rate () const
+    {
+        return hits + misses == 0 ? 0 : (double) hits / (hits + misses);
+    }
+};
+
+// Maximum number of (source, target, turn penalty) entries, about 100 bytes each plus stored paths (0: cache disabled)
+extern long long PATH_CACHE_CAPACITY;
+
+// Whether loadMap loads the cache from a file and closeMap saves it there
+extern bool use_path_cache_file;
+
+// File the cache is kept in (empty: path_cache_path of the map)
+extern std::string path_cache_file;
+
+// <map>.pathcache, in the directory of the map cache (see map_cache_path)
+std::string path_cache_path (const std::string& map_streets_database_filename);
+
+// Cached travel time (FLT_MAX if no path) and, if segments is not null, the cached street segments
+// A lookup for segments only hits if they were stored
+bool path_cache_lookup (IntersectionIdx source, IntersectionIdx target, double turn_penalty,
+                        float& cost, std::vector<StreetSegmentIdx>* segments = nullptr);
+void path_cache_insert (IntersectionIdx source, IntersectionIdx target, double turn_penalty, float cost);
+void path_cache_insert (IntersectionIdx source, IntersectionIdx target, double turn_penalty, float cost,
+                        const std::vector<StreetSegmentIdx>& segments);
+
+void clear_path_cache ();
+PathCacheStats path_cache_stats ();
+void reset_path_cache_stats ();
+
+// Map the cached entries were found on: CURRENT_MAP_PATH may already name the next map when closeMap runs
+std::string path_cache_map_path ();
+
+// The entries are saved for the map they were found on (path_cache_map_path), whatever the current map
+// Entries are only loaded if the whole file was read and saved for the current map, returns false otherwise
+bool save_path_cache (const std::string& filename);
+bool load_path_cache (const std::string& filename);
+
+// compute_travel_time_matrix(points, points, turn_penalty), searching only from the sources with a cached miss
+TravelTimeMatrix cached_travel_time_matrix (const std::vector<IntersectionIdx>& points, double turn_penalty);
+
+// matrix.path(source, target) through the cache
+std::vector<StreetSegmentIdx> cached_path (const TravelTimeMatrix& matrix, int source, int target);
+
+#endif /* PATH_CACHE_H */
@@ -0,0 +1,113 @@
+/************************************************************
+ * ROUTING HELPER FUNCTIONS
+ ************************************************************/
+
+#ifndef ROUTING_H
+#define ROUTING_H
+
+#include "m1.h"
+#include "globals.h"
+
+// Turn cost model shared by computePathTravelTime and all path searches
+// A turn happens whenever the street id changes between consecutive segments
+// from_street is -1 at the start of a path (no turn possible)
+inline double turn_cost (StreetIdx from_street, StreetIdx to_street, double turn_penalty)
+{
+    return (from_street != -1 && from_street != to_street) ? turn_penalty : 0;
+}
+
+// Reusable search state of one thread, indexed by intersection (node-based searches) or by edge (edge-based searches)
+// A label is only valid if its stamp equals the current generation, so starting a new search is O(1)
+// instead of clearing (or hashing into) per-query containers
+struct SearchWorkspace
+{
+    std::vector<double> g_value;                    // best known travel time to the state
+    std::vector<int> parent;                        // previous state on the best path (-1 at the start)
+    std::vector<StreetSegmentIdx> parent_segment;   // segment leading to the intersection (node-based searches)
+    std::vector<StreetIdx> parent_street;           // street of parent_segment (node-based searches)
+    std::vector<unsigned> label_generation;         // generation in which the label was last set
+    std::vector<unsigned> settled_generation;       // generation in which the state was settled
+    std::vector<std::pair<double, int>> heap;       // (key, state) min-heap, capacity kept between searches
+    unsigned generation = 0;
+    int settled_count = 0;                          // states settled since the search started
+
+    // Start a new search over states [0, size). Arrays only grow (e.g. after loading a bigger map)
+    void start_search (int size);
+
+    bool has_label (int state) const
+    {
+        return label_generation[state] == generation;
+    }
+    bool is_settled (int state) const
+    {
+        return settled_generation[state] == generation;
+    }
+    void set_label (int state, double g, int parent_state)
+    {
+        g_value[state] = g;
+        parent[state] = parent_state;
+        label_generation[state] = generation;
+    }
+    void settle (int state)
+    {
+        settled_generation[state] = generation;
+        settled_count++;
+    }
+
+    void push (double key, int state);
+    std::pair<double, int> pop ();
+};
+
+// Workspaces of the calling thread (each OpenMP thread gets its own)
+// Slot 0 is used by forward (or single direction) searches, slot 1 by backward searches
+const int NUM_WORKSPACE_SLOTS = 2;
+SearchWorkspace& get_search_workspace (int slot = 0);
+
+// Statistics of the last findPathAndTravelTime call made by the calling thread
+struct SearchStats
+{
+    int settled_states = 0;     // states taken off the queue (both directions for bidirectional searches)
+};
+const SearchStats& last_search_stats ();
+
+// Lower bound on the travel time between two intersections (for any turn penalty), used as the A* heuristic
+double travel_time_lower_bound (IntersectionIdx from, IntersectionIdx to);
+
+// Index: component, Value: 1 if some path leads there from from_component (itself included)
+// Paths between intersections never depend on the turn penalty, only on the components
+std::vector<char> reachable_components (int from_component);
+
+// Search engines available for point-to-point path finding
+// NODE_BASED: one label per intersection (fast, but may miss the optimal path under turn penalties)
+// EDGE_BASED: one label per (intersection, incoming segment) state, exactly optimal for any turn penalty
+// BIDIRECTIONAL: same result as EDGE_BASED, searching from both ends until the two searches meet
+// CONTRACTION_HIERARCHY: same result as EDGE_BASED, using the hierarchy if one was built for the turn penalty
+enum class PathSearchMode
+{
+    NODE_BASED,
+    EDGE_BASED,
+    BIDIRECTIONAL,
+    CONTRACTION_HIERARCHY
+};
+
+// Same as findPathBetweenIntersections, but also returns the travel time of the path found by the search
+// Returns {0, empty path} if no path exists
+std::pair<double, std::vector<StreetSegmentIdx>> findPathAndTravelTime (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty,
+                  PathSearchMode mode = PathSearchMode::EDGE_BASED);
+
+// A* over intersections (NODE_BASED mode)
+std::pair<double, std::vector<StreetSegmentIdx>> findPathNodeBased (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty);
+// A* over routing graph edges (EDGE_BASED mode)
+std::pair<double, std::vector<StreetSegmentIdx>> findPathEdgeBased (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty);
+// Bidirectional A* over routing graph edges with average potentials (BIDIRECTIONAL mode)
+std::pair<double, std::vector<StreetSegmentIdx>> findPathBidirectional (
+                  const std::pair<IntersectionIdx, IntersectionIdx> intersect_ids,
+                  const double turn_penalty);
+
+#endif /* ROUTING_H */
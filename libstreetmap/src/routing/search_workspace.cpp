@@ -0,0 +1,47 @@
+#include "routing/routing.hpp"
+#include <algorithm>
+#include <functional>
+
+void SearchWorkspace::start_search (int size)
+{
+    if (label_generation.size() < size)
+    {
+        g_value.resize(size);
+        parent.resize(size);
+        parent_segment.resize(size);
+        parent_street.resize(size);
+        label_generation.resize(size, 0);
+        settled_generation.resize(size, 0);
+    }
+    heap.clear();
+    settled_count = 0;
+
+    // On wrap-around, old stamps could match again --> Clear them once
+    generation++;
+    if (generation == 0)
+    {
+        std::fill(label_generation.begin(), label_generation.end(), 0);
+        std::fill(settled_generation.begin(), settled_generation.end(), 0);
+        generation = 1;
+    }
+}
+
+void SearchWorkspace::push (double key, int state)
+{
+    heap.push_back(std::make_pair(key, state));
+    std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<double, int>>());
+}
+
+std::pair<double, int> SearchWorkspace::pop ()
+{
+    std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<double, int>>());
+    std::pair<double, int> top = heap.back();
+    heap.pop_back();
+    return top;
+}
+
+SearchWorkspace& get_search_workspace (int slot)
+{
+    thread_local SearchWorkspace workspaces[NUM_WORKSPACE_SLOTS];
+    return workspaces[slot];
+}
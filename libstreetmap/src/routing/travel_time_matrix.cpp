@@ -0,0 +1,361 @@
+#include "routing/travel_time_matrix.hpp"
+#include "routing/routing.hpp"
+#include "routing/contraction_hierarchy.hpp"
+#include <algorithm>
+#include <climits>
+
+/*******************************************************************************************************************************
+ * GLOBAL VARIABLES & FUNCTION DECLARATIONS
+ ********************************************************************************************************************************/
+// Fill matrix.costs using bucket-based many-to-many search on the contraction hierarchy
+// The search trees and meeting states are kept in the matrix, searches stop past max_travel_time
+void matrix_contraction_hierarchy (TravelTimeMatrix& matrix, double max_travel_time);
+
+// Hierarchy edge that reached state in a retained search tree (-1 for the first state of the search)
+int tree_parent (const std::vector<std::pair<int, int>>& tree, int state);
+
+// Fill matrix.costs using one edge-based Dijkstra per source, stopped at the bounds
+// The searches share one dense target table (no hash lookup per settled edge), and only wait for reachable targets
+void matrix_one_to_many (TravelTimeMatrix& matrix, const MatrixSearchBounds& bounds);
+
+/*******************************************************************************************************************************
+ * MATRIX
+ ********************************************************************************************************************************/
+TravelTimeMatrix compute_travel_time_matrix (const std::vector<IntersectionIdx>& sources,
+                                             const std::vector<IntersectionIdx>& targets,
+                                             double turn_penalty,
+                                             const MatrixSearchBounds& bounds)
+{
+    TravelTimeMatrix matrix;
+    matrix.turn_penalty = turn_penalty;
+    matrix.sources = sources;
+    matrix.targets = targets;
+    matrix.costs.assign(sources.size() * targets.size(), FLT_MAX);
+    if (sources.empty() || targets.empty())
+    {
+        return matrix;
+    }
+
+    // The hierarchy is opt-in (never built by default), so the one-to-many searches are the usual path
+    // Buckets hold every target reached from a state, they cannot tell which targets are nearest to a source
+    if (contraction_hierarchy_ready(turn_penalty) && bounds.nearest_targets <= 0)
+    {
+        matrix_contraction_hierarchy(matrix, bounds.max_travel_time);
+    } else
+    {
+        matrix_one_to_many(matrix, bounds);
+    }
+
+    // Staying at the same intersection is free
+    for (int s = 0; s < sources.size(); s++)
+    {
+        for (int t = 0; t < targets.size(); t++)
+        {
+            if (sources[s] == targets[t])
+            {
+                matrix.costs[s * targets.size() + t] = 0;
+            }
+        }
+    }
+    return matrix;
+}
+
+std::vector<StreetSegmentIdx> TravelTimeMatrix::path (int source, int target) const
+{
+    std::vector<StreetSegmentIdx> result;
+    if (!has_path(source, target) || sources[source] == targets[target])
+    {
+        return result;
+    }
+    if (meeting_states.empty())
+    {
+        return findPathAndTravelTime(std::make_pair(sources[source], targets[target]), turn_penalty,
+                                     PathSearchMode::CONTRACTION_HIERARCHY).second;
+    }
+
+    // Forward half: hierarchy edges from the first state up to the meeting state
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    int meeting_state = meeting_states[source * targets.size() + target];
+    std::vector<int> forward_edges;
+    int first_state = meeting_state;
+    for (int edge_id = tree_parent(source_trees[source], first_state); edge_id != -1;
+         edge_id = tree_parent(source_trees[source], first_state))
+    {
+        forward_edges.push_back(edge_id);
+        first_state = edges[edge_id].from;
+    }
+    std::reverse(forward_edges.begin(), forward_edges.end());
+
+    // Unpack shortcuts into routing graph edges, then into street segments
+    std::vector<int> states = {first_state};
+    for (int edge_id : forward_edges)
+    {
+        unpack_ch_edge(edge_id, states);
+    }
+    // Backward half: hierarchy edges from the meeting state down to an edge entering the target
+    for (int state = meeting_state, edge_id = tree_parent(target_trees[target], state); edge_id != -1;
+         state = edges[edge_id].to, edge_id = tree_parent(target_trees[target], state))
+    {
+        unpack_ch_edge(edge_id, states);
+    }
+
+    result.reserve(states.size());
+    for (int state : states)
+    {
+        result.push_back(Routing_Graph.edge_segment[state]);
+    }
+    return result;
+}
+
+/*******************************************************************************************************************************
+ * HELPER FUNCTIONS
+ ********************************************************************************************************************************/
+void matrix_contraction_hierarchy (TravelTimeMatrix& matrix, double max_travel_time)
+{
+    const std::vector<CHEdge>& edges = Contraction_Hierarchy.edges;
+    int stateNum = Routing_Graph.edge_to.size();
+    int targetNum = matrix.targets.size();
+
+    // 1. Upward backward search from each target, starting on the edges entering it
+    // Every settled state gets a bucket entry (target index, travel time from the state to the target)
+    std::vector<std::vector<std::pair<int, double>>> target_spaces(targetNum);
+    matrix.target_trees.assign(targetNum, std::vector<std::pair<int, int>>());
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < targetNum; t++)
+    {
+        IntersectionIdx target_id = matrix.targets[t];
+        SearchWorkspace& backward = get_search_workspace(1);
+        backward.start_search(stateNum);
+        for (int i = Routing_Graph.in_offsets[target_id]; i < Routing_Graph.in_offsets[target_id + 1]; i++)
+        {
+            int edge = Routing_Graph.in_edges[i];
+            backward.set_label(edge, 0, -1);
+            backward.push(0, edge);
+        }
+        while (!backward.heap.empty())
+        {
+            int state = backward.pop().second;
+            if (backward.is_settled(state))
+            {
+                continue;
+            }
+            // Both halves of a path within the bound are within it too
+            if (backward.g_value[state] > max_travel_time)
+            {
+                break;
+            }
+            backward.settle(state);
+            target_spaces[t].push_back(std::make_pair(state, backward.g_value[state]));
+            matrix.target_trees[t].push_back(std::make_pair(state, backward.parent[state]));
+            for (int i = Contraction_Hierarchy.down_offsets[state]; i < Contraction_Hierarchy.down_offsets[state + 1]; i++)
+            {
+                const CHEdge& edge = edges[Contraction_Hierarchy.down_edges[i]];
+                double g = backward.g_value[state] + edge.weight;
+                if (!backward.has_label(edge.from) || g < backward.g_value[edge.from])
+                {
+                    backward.set_label(edge.from, g, Contraction_Hierarchy.down_edges[i]);
+                    backward.push(g, edge.from);
+                }
+            }
+        }
+        std::sort(matrix.target_trees[t].begin(), matrix.target_trees[t].end());
+    }
+
+    // Buckets in CSR form: bucket_entries[bucket_offsets[state] .. bucket_offsets[state + 1])
+    std::vector<int> bucket_offsets(stateNum + 1, 0);
+    for (const auto& space : target_spaces)
+    {
+        for (const auto& entry : space)
+        {
+            bucket_offsets[entry.first + 1]++;
+        }
+    }
+    for (int state = 0; state < stateNum; state++)
+    {
+        bucket_offsets[state + 1] += bucket_offsets[state];
+    }
+    std::vector<std::pair<int, double>> bucket_entries(bucket_offsets[stateNum]);
+    std::vector<int> fill(bucket_offsets.begin(), bucket_offsets.end() - 1);
+    for (int t = 0; t < targetNum; t++)
+    {
+        for (const auto& entry : target_spaces[t])
+        {
+            bucket_entries[fill[entry.first]++] = std::make_pair(t, entry.second);
+        }
+    }
+    target_spaces.clear();
+
+    // 2. Upward forward search from each source, starting on the edges leaving it
+    // A target is reached through any settled state whose bucket holds it; the best sum is exact
+    matrix.source_trees.assign(matrix.sources.size(), std::vector<std::pair<int, int>>());
+    matrix.meeting_states.assign(matrix.costs.size(), -1);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int s = 0; s < matrix.sources.size(); s++)
+    {
+        IntersectionIdx source_id = matrix.sources[s];
+        std::vector<double> row(targetNum, DBL_MAX);
+        SearchWorkspace& forward = get_search_workspace(0);
+        forward.start_search(stateNum);
+        for (int edge = Routing_Graph.offsets[source_id]; edge < Routing_Graph.offsets[source_id + 1]; edge++)
+        {
+            forward.set_label(edge, Routing_Graph.edge_travel_time[edge], -1);
+            forward.push(Routing_Graph.edge_travel_time[edge], edge);
+        }
+        while (!forward.heap.empty())
+        {
+            int state = forward.pop().second;
+            if (forward.is_settled(state))
+            {
+                continue;
+            }
+            if (forward.g_value[state] > max_travel_time)
+            {
+                break;
+            }
+            forward.settle(state);
+            matrix.source_trees[s].push_back(std::make_pair(state, forward.parent[state]));
+            double g_state = forward.g_value[state];
+            for (int i = bucket_offsets[state]; i < bucket_offsets[state + 1]; i++)
+            {
+                int t = bucket_entries[i].first;
+                if (g_state + bucket_entries[i].second < row[t])
+                {
+                    row[t] = g_state + bucket_entries[i].second;
+                    matrix.meeting_states[s * targetNum + t] = state;
+                }
+            }
+            for (int i = Contraction_Hierarchy.up_offsets[state]; i < Contraction_Hierarchy.up_offsets[state + 1]; i++)
+            {
+                const CHEdge& edge = edges[Contraction_Hierarchy.up_edges[i]];
+                double g = g_state + edge.weight;
+                if (!forward.has_label(edge.to) || g < forward.g_value[edge.to])
+                {
+                    forward.set_label(edge.to, g, Contraction_Hierarchy.up_edges[i]);
+                    forward.push(g, edge.to);
+                }
+            }
+        }
+        std::sort(matrix.source_trees[s].begin(), matrix.source_trees[s].end());
+        for (int t = 0; t < targetNum; t++)
+        {
+            if (row[t] <= max_travel_time && row[t] < DBL_MAX)
+            {
+                matrix.costs[s * targetNum + t] = row[t];
+            }
+        }
+    }
+}
+
+void matrix_one_to_many (TravelTimeMatrix& matrix, const MatrixSearchBounds& bounds)
+{
+    int targetNum = matrix.targets.size();
+    // Indices of each target intersection in matrix.targets, as linked lists
+    // first_target: Index: intersection, Value: first index (-1 if not a target), next_target: Index / Value: target index
+    std::vector<int> first_target(Routing_Graph.offsets.size() - 1, -1);
+    std::vector<int> next_target(targetNum, -1);
+    std::vector<IntersectionIdx> unique_targets;
+    for (int t = targetNum - 1; t >= 0; t--)
+    {
+        if (first_target[matrix.targets[t]] == -1)
+        {
+            unique_targets.push_back(matrix.targets[t]);
+        }
+        next_target[t] = first_target[matrix.targets[t]];
+        first_target[matrix.targets[t]] = t;
+    }
+
+    // A search only waits for the targets its source can reach: an unreachable target would make it settle
+    // everything reachable. Index: source index, Value: number of reachable target intersections
+    std::vector<int> reachable_targets(matrix.sources.size());
+    std::vector<std::pair<int, int>> component_targets;    // (source component, reachable targets), one per component
+    for (int s = 0; s < matrix.sources.size(); s++)
+    {
+        int component = Routing_Graph.component[matrix.sources[s]];
+        auto it = std::find_if(component_targets.begin(), component_targets.end(),
+                               [&](const std::pair<int, int>& entry) { return entry.first == component; });
+        if (it == component_targets.end())
+        {
+            std::vector<char> reachable = reachable_components(component);
+            int count = 0;
+            for (IntersectionIdx target : unique_targets)
+            {
+                count += reachable[Routing_Graph.component[target]];
+            }
+            component_targets.push_back(std::make_pair(component, count));
+            it = component_targets.end() - 1;
+        }
+        reachable_targets[s] = it->second;
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int s = 0; s < matrix.sources.size(); s++)
+    {
+        IntersectionIdx source_id = matrix.sources[s];
+        int targets_left = reachable_targets[s] - (first_target[source_id] != -1);
+        if (bounds.nearest_targets > 0)
+        {
+            targets_left = std::min(targets_left, bounds.nearest_targets);
+        }
+        if (targets_left == 0)
+        {
+            continue;
+        }
+
+        // Edge-based Dijkstra: the first settled edge entering a target gives its travel time
+        // With nearest_targets, the first targets reached are the nearest ones
+        SearchWorkspace& workspace = get_search_workspace();
+        workspace.start_search(Routing_Graph.edge_to.size());
+        for (int edge = Routing_Graph.offsets[source_id]; edge < Routing_Graph.offsets[source_id + 1]; edge++)
+        {
+            workspace.set_label(edge, Routing_Graph.edge_travel_time[edge], -1);
+            workspace.push(Routing_Graph.edge_travel_time[edge], edge);
+        }
+        while (!workspace.heap.empty() && targets_left > 0)
+        {
+            int current = workspace.pop().second;
+            if (workspace.is_settled(current))
+            {
+                continue;
+            }
+            // Edges are settled in travel time order: every target left is further than the bound
+            if (workspace.g_value[current] > bounds.max_travel_time)
+            {
+                break;
+            }
+            workspace.settle(current);
+
+            IntersectionIdx intersection = Routing_Graph.edge_to[current];
+            int first = first_target[intersection];
+            if (first != -1 && intersection != source_id && matrix.costs[s * targetNum + first] == FLT_MAX)
+            {
+                for (int t = first; t != -1; t = next_target[t])
+                {
+                    matrix.costs[s * targetNum + t] = workspace.g_value[current];
+                }
+                targets_left--;
+            }
+
+            StreetIdx current_street = Routing_Graph.edge_street[current];
+            for (int edge = Routing_Graph.offsets[intersection]; edge < Routing_Graph.offsets[intersection + 1]; edge++)
+            {
+                if (workspace.is_settled(edge))
+                {
+                    continue;
+                }
+                double g = workspace.g_value[current] + turn_cost(current_street, Routing_Graph.edge_street[edge], matrix.turn_penalty);
+                g += Routing_Graph.edge_travel_time[edge];
+                if (!workspace.has_label(edge) || g < workspace.g_value[edge])
+                {
+                    workspace.set_label(edge, g, current);
+                    workspace.push(g, edge);
+                }
+            }
+        }
+    }
+}
+
+int tree_parent (const std::vector<std::pair<int, int>>& tree, int state)
+{
+    auto it = std::lower_bound(tree.begin(), tree.end(), std::make_pair(state, INT_MIN));
+    return it->second;
+}
@@ -0,0 +1,72 @@
+/************************************************************
+ * MANY-TO-MANY TRAVEL TIME MATRIX
+ *
+ * Travel times (turn penalties included) from every source to
+ * every target intersection, computed in one call:
+ * - By default one edge-based Dijkstra per source (in parallel),
+ *   stopped once all targets are reached
+ * - Bucket-based on the contraction hierarchy only if one was built
+ *   for the turn penalty (opt-in, see contraction_hierarchy.hpp):
+ *   one upward backward search per target leaves (target, time)
+ *   entries in buckets, then one upward forward search per source
+ *   scans the buckets of the states it settles
+ * The one-to-many searches skip the targets their source cannot reach
+ * (other strongly connected components, labelled at load), so one
+ * unreachable target does not make a search settle the whole map.
+ * Searches can also be bounded (MatrixSearchBounds): each source then
+ * only looks for the targets within a travel time, or for its k
+ * nearest targets.
+ * Paths are not stored, only reconstructed for the pairs asked for:
+ * from the retained hierarchy search trees if the hierarchy was used,
+ * otherwise by a new point-to-point query.
+ ************************************************************/
+
+#ifndef TRAVEL_TIME_MATRIX_H
+#define TRAVEL_TIME_MATRIX_H
+
+#include <cfloat>
+#include <limits>
+#include "m1.h"
+#include "globals.h"
+
+struct TravelTimeMatrix
+{
+    double turn_penalty = 0;
+    std::vector<IntersectionIdx> sources;
+    std::vector<IntersectionIdx> targets;
+    // Index: source index * targets.size() + target index, Value: travel time (FLT_MAX if no path)
+    std::vector<float> costs;
+
+    // Hierarchy searches kept to rebuild paths (empty if the one-to-many searches were used)
+    // Index: source / target index, Value: (state, hierarchy edge the state was reached by or -1), sorted by state
+    std::vector<std::vector<std::pair<int, int>>> source_trees;
+    std::vector<std::vector<std::pair<int, int>>> target_trees;
+    // Same indexing as costs, Value: state where the two searches of the best path met
+    std::vector<int> meeting_states;
+
+    float cost (int source, int target) const
+    {
+        return costs[source * targets.size() + target];
+    }
+    bool has_path (int source, int target) const
+    {
+        return cost(source, target) < FLT_MAX;
+    }
+    // Street segments from sources[source] to targets[target] (empty if no path or same intersection)
+    std::vector<StreetSegmentIdx> path (int source, int target) const;
+};
+
+// Limits on the search from each source, targets outside them are left at FLT_MAX (no path)
+struct MatrixSearchBounds
+{
+    double max_travel_time = std::numeric_limits<double>::infinity();
+    int nearest_targets = 0;        // Stop once this many target intersections (other than the source) are reached (0: all)
+};
+
+// One-to-many searches, or hierarchy buckets if a hierarchy exists for the turn penalty and nearest_targets is 0
+TravelTimeMatrix compute_travel_time_matrix (const std::vector<IntersectionIdx>& sources,
+                                             const std::vector<IntersectionIdx>& targets,
+                                             double turn_penalty,
+                                             const MatrixSearchBounds& bounds = MatrixSearchBounds());
+
+#endif /* TRAVEL_TIME_MATRIX_H */
@@ -324,6 +324,134 @@ bool courier_path_is_legal(const std::vector<DeliveryInf>& deliveries,
 }
 
 
+bool fleet_paths_are_legal(const std::vector<DeliveryInf>& deliveries,
+                           const std::vector<IntersectionIdx>& depots,
+                           const std::vector<std::vector<CourierSubPath>>& routes,
+                           const int capacity,
+                           const std::vector<IntersectionIdx>& vehicle_depots) {
+
+    //
+    //Ensuree we have a valid problem specification
+    //
+    if(!valid_courier_problem(deliveries, depots)) {
+        return false;
+    }
+
+    if (!vehicle_depots.empty() && vehicle_depots.size() != routes.size()) {
+        std::cerr << "Invalid fleet: " << routes.size() << " routes for " << vehicle_depots.size() << " vehicles" << std::endl;
+        return false;
+    }
+
+    std::vector<bool> deliveries_completed(deliveries.size(), false);
+    std::vector<std::vector<IntersectionIdx>> route_stops(routes.size());
+    std::vector<std::vector<int>> route_loads(routes.size());  //Packages carried when leaving each stop
+
+    for (size_t route_idx = 0; route_idx < routes.size(); route_idx++) {
+        const std::vector<CourierSubPath>& path = routes[route_idx];
+        if (path.empty()) {
+            //Vehicle not used
+            continue;
+        }
+
+        auto print_route_error_message = [&](auto&& message_printer) {
+            std::cerr << "Invalid fleet route " << route_idx << ": ";
+            message_printer(std::cerr);
+            std::cerr << std::endl;
+        };
+
+        if (!is_depot(depots, path[0].start_intersection) ||
+            !is_depot(depots, path[path.size() - 1].end_intersection)) {
+            print_route_error_message([&](auto&&s){s << "does not start and end at a depot";});
+            return false;
+        }
+        if (!vehicle_depots.empty() && (path[0].start_intersection != vehicle_depots[route_idx] ||
+                                        path[path.size() - 1].end_intersection != vehicle_depots[route_idx])) {
+            print_route_error_message([&](auto&&s){s << "does not start and end at the depot of its vehicle ("
+                                                     << vehicle_depots[route_idx] << ")";});
+            return false;
+        }
+
+        //
+        //Structure: connected subpaths, each one a valid walk from its start to its end intersection
+        //
+        for (size_t sub_idx = 0; sub_idx < path.size(); sub_idx++) {
+            const CourierSubPath& courier_subpath = path[sub_idx];
+            if (sub_idx > 0 && courier_subpath.start_intersection != path[sub_idx - 1].end_intersection) {
+                print_route_error_message([&](auto&&s){s << "subpath " << sub_idx << " does not start where the previous one ends";});
+                return false;
+            }
+            if (!is_start_intersection_correct(courier_subpath) || !is_end_intersection_correct(courier_subpath)) {
+                print_route_error_message([&](auto&&s){s << "subpath " << sub_idx << " has wrong start / end intersection";});
+                return false;
+            }
+            IntersectionIdx curr_intersection = courier_subpath.start_intersection;
+            for (size_t subpath_idx = 0; subpath_idx < courier_subpath.subpath.size(); ++subpath_idx) {
+                IntersectionIdx next_intersection; //Set by traverse_segment
+                if(!traverse_segment(courier_subpath.subpath, subpath_idx, curr_intersection, next_intersection)) {
+                    return false;
+                }
+                curr_intersection = next_intersection;
+            }
+            if (curr_intersection != courier_subpath.end_intersection) {
+                print_route_error_message([&](auto&&s){s << "subpath " << sub_idx << " does not reach its end_intersection";});
+                return false;
+            }
+        }
+
+        //The vehicle stops between consecutive subpaths
+        for (size_t sub_idx = 1; sub_idx < path.size(); sub_idx++) {
+            route_stops[route_idx].push_back(path[sub_idx].start_intersection);
+        }
+        route_loads[route_idx].assign(route_stops[route_idx].size(), 0);
+    }
+
+    //
+    //Packages: stops do not say which packages are picked up or dropped off, so each delivery is
+    //given to the first vehicle, and the first stop at its dropOff in that route, that completes it
+    //within capacity. It is carried from the last stop at its pickUp before that dropOff stop (the
+    //shortest carry ending there)
+    //
+    for (size_t delivery_idx = 0; delivery_idx < deliveries.size(); ++delivery_idx) {
+        for (size_t route_idx = 0; route_idx < routes.size() && !deliveries_completed[delivery_idx]; route_idx++) {
+            const std::vector<IntersectionIdx>& stops = route_stops[route_idx];
+            std::vector<int>& loads = route_loads[route_idx];
+            int pick_up_stop = -1;
+            for (size_t stop_idx = 0; stop_idx < stops.size(); stop_idx++) {
+                if (pick_up_stop != -1 && stops[stop_idx] == deliveries[delivery_idx].dropOff) {
+                    //Carried when leaving stops [pick_up_stop, stop_idx)
+                    if (capacity <= 0 || *std::max_element(loads.begin() + pick_up_stop, loads.begin() + stop_idx) < capacity) {
+                        deliveries_completed[delivery_idx] = true;
+                        for (size_t carry_idx = pick_up_stop; carry_idx < stop_idx; carry_idx++) {
+                            loads[carry_idx]++;
+                        }
+                        break;
+                    }
+                }
+                if (stops[stop_idx] == deliveries[delivery_idx].pickUp) {
+                    if (deliveries[delivery_idx].pickUp == deliveries[delivery_idx].dropOff) {
+                        //Dropped off where it is picked up: never carried
+                        deliveries_completed[delivery_idx] = true;
+                        break;
+                    }
+                    pick_up_stop = stop_idx;
+                }
+            }
+        }
+        if (!deliveries_completed[delivery_idx]) {
+            std::cerr << "Invalid fleet routes: delivery " << delivery_idx << " was not completed by any vehicle";
+            if (capacity > 0) {
+                std::cerr << " (within capacity " << capacity << ")";
+            }
+            std::cerr << std::endl;
+            return false;
+        }
+    }
+
+    //Everything validated
+    return true;
+}
+
+
 bool valid_courier_problem(const std::vector<DeliveryInf>& deliveries_vec,
                            const std::vector<IntersectionIdx>& depots_vec) {
     if(deliveries_vec.empty()) {
@@ -39,6 +39,16 @@ bool courier_path_is_legal(const std::vector<DeliveryInf>& deliveries,
                           const std::vector<IntersectionIdx>& depots,
                           const std::vector<CourierSubPath>& path);
 
+//Multi-vehicle variant: every route (one per vehicle, empty if unused) must be a legal
+//depot-to-depot courier path, every delivery must be completed by one vehicle, and no
+//vehicle may carry more than capacity packages at once (capacity <= 0: unlimited)
+//If vehicle_depots is not empty, route i must also start and end at vehicle_depots[i]
+bool fleet_paths_are_legal(const std::vector<DeliveryInf>& deliveries,
+                           const std::vector<IntersectionIdx>& depots,
+                           const std::vector<std::vector<CourierSubPath>>& routes,
+                           const int capacity,
+                           const std::vector<IntersectionIdx>& vehicle_depots = {});
+
 bool valid_courier_problem(const std::vector<DeliveryInf>& deliveries,
                            const std::vector<IntersectionIdx>& depots);
 
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstdio>
+#include <UnitTest++/UnitTest++.h>
+
+#include "m1.h"
+#include "globals.h"
+#include "map_cache.h"
+
+SUITE(map_cache_toronto_canada) {
+    // The structures loaded from the cache are the ones the cache was written from
+    TEST(map_cache_round_trip) {
+        std::string streets_filename = "/cad2/ece297s/public/maps/toronto_canada.streets.bin";
+        std::string osm_filename = "/cad2/ece297s/public/maps/toronto_canada.osm.bin";
+        std::string filename = "map_cache_test.mapcache";
+        // Kept in the user's cache directory by default: the map directory is read-only
+        std::string cache_directory = user_cache_directory();
+        CHECK(!cache_directory.empty());
+        CHECK_EQUAL(cache_directory + "/toronto_canada.mapcache", map_cache_path(streets_filename));
+        map_cache_directory = "/tmp";
+        CHECK_EQUAL("/tmp/toronto_canada.mapcache", map_cache_path(streets_filename));
+        map_cache_directory.clear();
+        CHECK(save_map_cache(filename, streets_filename, osm_filename));
+
+        StreetSegmentStore segments = Street_Segments;
+        std::vector<IntersectionInfo> intersections = Intersection_IntersectionInfo;
+        std::vector<FeatureDetailedInfo> features = Features_AllInfo;
+        std::vector<double> edge_travel_time = Routing_Graph.edge_travel_time;
+        double max_speed_limit = MAX_SPEED_LIMIT;
+        Street_Segments.clear();
+        Intersection_IntersectionInfo.clear();
+        Features_AllInfo.clear();
+        CHECK(load_map_cache(filename, streets_filename, osm_filename));
+
+        CHECK_EQUAL(segments.size(), Street_Segments.size());
+        CHECK(segments.travel_time == Street_Segments.travel_time);
+        CHECK(segments.highway_type == Street_Segments.highway_type);
+        CHECK(segments.street_name_arrow == Street_Segments.street_name_arrow);
+        CHECK(segments.from == Street_Segments.from && segments.to == Street_Segments.to);
+        for (int i = 0; i < segments.size() && i < Street_Segments.size(); i += 97) {
+            CHECK_EQUAL(segments.length[i], Street_Segments.length[i]);
+            CHECK_EQUAL(segments.curve_points_xy[i].size(), Street_Segments.curve_points_xy[i].size());
+            CHECK_EQUAL(segments.poly_points[i].size(), Street_Segments.poly_points[i].size());
+            // Loaded geometry is appended to Geometry_Points: the ranges copied above are still valid
+            CHECK(std::equal(segments.poly_points[i].begin(), segments.poly_points[i].end(),
+                             Street_Segments.poly_points[i].begin(),
+                             [](ezgl::point2d a, ezgl::point2d b) { return a.x == b.x && a.y == b.y; }));
+            CHECK_EQUAL(segments.bounds[i].left(), Street_Segments.bounds[i].left());
+        }
+        CHECK_EQUAL(intersections.size(), Intersection_IntersectionInfo.size());
+        for (std::size_t i = 0; i < intersections.size() && i < Intersection_IntersectionInfo.size(); i += 97) {
+            CHECK_EQUAL(intersections[i].name, Intersection_IntersectionInfo[i].name);
+            CHECK_EQUAL(intersections[i].position_xy.x, Intersection_IntersectionInfo[i].position_xy.x);
+            CHECK(intersections[i].all_segments == Intersection_IntersectionInfo[i].all_segments);
+        }
+        CHECK_EQUAL(features.size(), Features_AllInfo.size());
+        for (std::size_t i = 0; i < features.size() && i < Features_AllInfo.size(); i += 17) {
+            CHECK_EQUAL(features[i].id, Features_AllInfo[i].id);
+            CHECK_EQUAL(features[i].featureArea, Features_AllInfo[i].featureArea);
+            CHECK_EQUAL(features[i].featurePoints.size(), Features_AllInfo[i].featurePoints.size());
+        }
+        CHECK(edge_travel_time == Routing_Graph.edge_travel_time);
+        CHECK_EQUAL(max_speed_limit, MAX_SPEED_LIMIT);
+
+        // Ids out of range in the plain arrays: corrupt, nothing is loaded
+        IntersectionIdx edge_to = Routing_Graph.edge_to[0];
+        Routing_Graph.edge_to[0] = Intersection_IntersectionInfo.size();
+        CHECK(save_map_cache(filename, streets_filename, osm_filename));
+        Routing_Graph.edge_to[0] = edge_to;
+        Street_Segments.clear();
+        CHECK(!load_map_cache(filename, streets_filename, osm_filename));
+        CHECK_EQUAL(0, Street_Segments.size());
+        Street_Segments = segments;
+        CHECK(save_map_cache(filename, streets_filename, osm_filename));
+
+        // Written from other databases: stale
+        CHECK(!load_map_cache(filename, osm_filename, streets_filename));
+        std::remove(filename.c_str());
+        CHECK(!load_map_cache(filename, streets_filename, osm_filename));
+    }
+}
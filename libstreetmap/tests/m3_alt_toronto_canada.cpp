@@ -0,0 +1,101 @@
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+#include "routing/landmarks.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+// Travel time from source to every intersection (no turn penalty, infinity if unreachable), by plain Dijkstra
+static std::vector<double> dijkstra_travel_times(IntersectionIdx source) {
+    std::vector<double> times(Routing_Graph.offsets.size() - 1, std::numeric_limits<double>::infinity());
+    std::priority_queue<std::pair<double, IntersectionIdx>, std::vector<std::pair<double, IntersectionIdx>>,
+                        std::greater<std::pair<double, IntersectionIdx>>> queue;
+    times[source] = 0;
+    queue.push({0, source});
+    while (!queue.empty()) {
+        auto [time, current] = queue.top();
+        queue.pop();
+        if (time > times[current]) {
+            continue;
+        }
+        for (int edge = Routing_Graph.offsets[current]; edge < Routing_Graph.offsets[current + 1]; edge++) {
+            double next_time = time + Routing_Graph.edge_travel_time[edge];
+            if (next_time < times[Routing_Graph.edge_to[edge]]) {
+                times[Routing_Graph.edge_to[edge]] = next_time;
+                queue.push({next_time, Routing_Graph.edge_to[edge]});
+            }
+        }
+    }
+    return times;
+}
+
+
+SUITE(alt_landmarks_toronto_canada) {
+    // The landmark bounds are admissible, so A* finds the same travel times as with the straight-line heuristic
+    TEST(alt_vs_straight_line_heuristic) {
+        std::vector<std::pair<IntersectionIdx, IntersectionIdx>> intersection_pairs = {
+            {23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917},
+            {33059, 39404}, {30720, 67693}, {36317, 25933}, {129351, 151543}, {41283, 54262}};
+        std::vector<double> turn_penalties = {0.0, 15.0};
+
+        // No landmarks (not just cleared: the first search would compute them)
+        std::vector<double> straight_line_times;
+        init_landmarks(0);
+        for (double turn_penalty : turn_penalties) {
+            for (const auto& intersection_pair : intersection_pairs) {
+                straight_line_times.push_back(findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::EDGE_BASED).first);
+            }
+        }
+
+        init_landmarks(NUM_LANDMARKS);
+        CHECK(ALT_Landmarks.count > 0);
+        int i = 0;
+        for (double turn_penalty : turn_penalties) {
+            for (const auto& intersection_pair : intersection_pairs) {
+                auto [alt_time, alt_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::EDGE_BASED);
+                CHECK(path_is_legal(intersection_pair.first, intersection_pair.second, alt_path));
+                CHECK(relative_error(alt_time, straight_line_times[i++]) < 1e-9);
+                CHECK(landmark_lower_bound(intersection_pair.first, intersection_pair.second) <= alt_time + 1e-6);
+            }
+        }
+    }
+
+    // The landmark bounds must be consistent, not only admissible: every landmark search (settled nodes never
+    // reopened, bidirectional stopping rule) finds the shortest travel time of plain Dijkstra on random pairs
+    TEST(alt_vs_plain_dijkstra) {
+        init_landmarks(NUM_LANDMARKS);
+        CHECK(ALT_Landmarks.count > 0);
+        int intersection_count = Routing_Graph.offsets.size() - 1;
+        std::mt19937 rng(297);
+        for (int source_idx = 0; source_idx < 20; source_idx++) {
+            IntersectionIdx source = rng() % intersection_count;
+            std::vector<double> times = dijkstra_travel_times(source);
+            for (int target_idx = 0; target_idx < 10; target_idx++) {
+                IntersectionIdx target = rng() % intersection_count;
+                if (target == source) {
+                    continue;
+                }
+                for (PathSearchMode mode : {PathSearchMode::NODE_BASED, PathSearchMode::EDGE_BASED, PathSearchMode::BIDIRECTIONAL}) {
+                    auto [time, path] = findPathAndTravelTime({source, target}, 0.0, mode);
+                    if (times[target] == std::numeric_limits<double>::infinity()) {
+                        CHECK(path.empty());
+                    } else {
+                        CHECK(path_is_legal(source, target, path));
+                        CHECK(relative_error(time, times[target]) < 1e-9);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+
+SUITE(bidirectional_search_toronto_canada) {
+    // Both searches are exact, so the bidirectional search must find the same travel times (one-way streets and
+    // turn penalties are handled on the backward side through the reverse adjacency)
+    TEST(bidirectional_vs_edge_based) {
+        std::vector<std::pair<IntersectionIdx, IntersectionIdx>> intersection_pairs = {
+            {23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917},
+            {33059, 39404}, {30720, 67693}, {36317, 25933}, {129351, 151543}, {41283, 54262},
+            {32645, 70504}, {73536, 17212}, {119925, 5790}, {154741, 102215}, {42566, 168058}};
+        std::vector<double> turn_penalties = {0.0, 15.0, 30.0};
+
+        for (double turn_penalty : turn_penalties) {
+            for (const auto& intersection_pair : intersection_pairs) {
+                auto [edge_time, edge_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::EDGE_BASED);
+                auto [bidirectional_time, bidirectional_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::BIDIRECTIONAL);
+
+                CHECK(path_is_legal(intersection_pair.first, intersection_pair.second, bidirectional_path));
+                CHECK(relative_error(bidirectional_time, computePathTravelTime(bidirectional_path, turn_penalty)) < 1e-9);
+                CHECK(relative_error(bidirectional_time, edge_time) < 1e-9);
+            }
+        }
+    }
+
+    TEST(bidirectional_same_start_and_destination) {
+        auto [travel_time, path] = findPathAndTravelTime({23285, 23285}, 15.0, PathSearchMode::BIDIRECTIONAL);
+        CHECK(path.empty());
+        CHECK_EQUAL(0.0, travel_time);
+    }
+}
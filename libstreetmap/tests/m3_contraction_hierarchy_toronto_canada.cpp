@@ -0,0 +1,40 @@
+#include <iostream>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+#include "routing/contraction_hierarchy.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+
+SUITE(contraction_hierarchy_toronto_canada) {
+    // Queries on the hierarchy must return paths as fast as the exact edge-based A*
+    TEST(contraction_hierarchy_vs_edge_based) {
+        std::vector<std::pair<IntersectionIdx, IntersectionIdx>> intersection_pairs = {
+            {23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917},
+            {33059, 39404}, {30720, 67693}, {36317, 25933}, {129351, 151543}, {41283, 54262},
+            {32645, 70504}, {73536, 17212}, {119925, 5790}, {154741, 102215}, {42566, 168058}};
+        double turn_penalty = 15.0;
+
+        // Built once for the whole test run, the travel time matrix tests reuse it
+        ensure_contraction_hierarchy(turn_penalty);
+        CHECK(contraction_hierarchy_ready(turn_penalty));
+        CHECK(!contraction_hierarchy_ready(30.0));
+
+        for (const auto& intersection_pair : intersection_pairs) {
+            auto [ch_time, ch_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::CONTRACTION_HIERARCHY);
+            auto [astar_time, astar_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::EDGE_BASED);
+
+            CHECK(path_is_legal(intersection_pair.first, intersection_pair.second, ch_path));
+            CHECK(relative_error(ch_time, computePathTravelTime(ch_path, turn_penalty)) < 1e-9);
+            CHECK(relative_error(ch_time, astar_time) < 1e-9);
+        }
+    }
+}
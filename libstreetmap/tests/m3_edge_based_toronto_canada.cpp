@@ -0,0 +1,47 @@
+#include <iostream>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+
+SUITE(edge_based_search_toronto_canada) {
+    // Regression against the node-based engine: the edge-based search is exact, so it is never slower,
+    // and both engines agree when there is no turn penalty
+    TEST(edge_based_vs_node_based) {
+        std::vector<std::pair<IntersectionIdx, IntersectionIdx>> intersection_pairs = {
+            {23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917},
+            {33059, 39404}, {30720, 67693}, {36317, 25933}, {129351, 151543}, {41283, 54262},
+            {32645, 70504}, {73536, 17212}, {119925, 5790}, {154741, 102215}, {42566, 168058},
+            {31970, 120356}, {35737, 4553}, {124331, 156932}, {153404, 97799}, {180613, 151301}};
+        std::vector<double> turn_penalties = {0.0, 15.0, 30.0};
+
+        for (double turn_penalty : turn_penalties) {
+            for (const auto& intersection_pair : intersection_pairs) {
+                auto [node_time, node_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::NODE_BASED);
+                auto [edge_time, edge_path] = findPathAndTravelTime(intersection_pair, turn_penalty, PathSearchMode::EDGE_BASED);
+
+                CHECK(path_is_legal(intersection_pair.first, intersection_pair.second, edge_path));
+                CHECK(relative_error(edge_time, computePathTravelTime(edge_path, turn_penalty)) < 1e-9);
+                CHECK(edge_time <= node_time + 1e-6);
+                if (turn_penalty == 0) {
+                    CHECK(relative_error(edge_time, node_time) < 1e-9);
+                }
+            }
+        }
+    }
+
+    TEST(edge_based_same_start_and_destination) {
+        auto [travel_time, path] = findPathAndTravelTime({23285, 23285}, 15.0, PathSearchMode::EDGE_BASED);
+        CHECK(path.empty());
+        CHECK_EQUAL(0.0, travel_time);
+    }
+}
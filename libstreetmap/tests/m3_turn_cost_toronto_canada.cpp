@@ -0,0 +1,41 @@
+#include <iostream>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+
+SUITE(turn_cost_toronto_canada) {
+    // The travel time a search reports must agree with computePathTravelTime on the returned path
+    // (both use the same StreetIdx-based turn cost model)
+    TEST(search_cost_matches_path_travel_time) {
+        std::vector<std::pair<IntersectionIdx, IntersectionIdx>> intersection_pairs = {
+            {23285, 30394}, {65052, 98292}, {69434, 112840}, {165581, 51879}, {76559, 147917},
+            {33059, 39404}, {30720, 67693}, {36317, 25933}, {129351, 151543}, {41283, 54262},
+            {32645, 70504}, {73536, 17212}, {119925, 5790}, {154741, 102215}, {42566, 168058}};
+        std::vector<double> turn_penalties = {0.0, 15.0, 30.0};
+
+        for (double turn_penalty : turn_penalties) {
+            for (const auto& intersection_pair : intersection_pairs) {
+                auto [travel_time, path] = findPathAndTravelTime(intersection_pair, turn_penalty);
+                CHECK(path_is_legal(intersection_pair.first, intersection_pair.second, path));
+                CHECK(relative_error(travel_time, computePathTravelTime(path, turn_penalty)) < 1e-9);
+                CHECK_EQUAL(path, findPathBetweenIntersections(intersection_pair, turn_penalty));
+            }
+        }
+    }
+
+    TEST(turn_cost_on_street_change) {
+        CHECK_EQUAL(0.0, turn_cost(-1, 5, 15.0));
+        CHECK_EQUAL(0.0, turn_cost(5, 5, 15.0));
+        CHECK_EQUAL(15.0, turn_cost(5, 6, 15.0));
+    }
+}
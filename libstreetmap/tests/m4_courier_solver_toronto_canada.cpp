@@ -0,0 +1,73 @@
+#include <random>
+#include <iostream>
+#include <chrono>
+#include <limits>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "m4.h"
+#include "courier/courier_solver.hpp"
+
+#include "unit_test_util.h"
+#include "courier_verify.h"
+
+using ece297test::relative_error;
+using ece297test::courier_path_is_legal;
+
+
+SUITE(courier_solver_toronto_canada) {
+    // The anytime solver must return by its deadline, and report only legal, strictly better routes,
+    // the last of which is the result (possibly reported after the return: the callback owns its state)
+    TEST(courier_anytime_improvements) {
+        std::vector<DeliveryInf> deliveries = {DeliveryInf(124331, 156932), DeliveryInf(25964, 156932), DeliveryInf(67812, 156932),
+                                               DeliveryInf(153404, 97799), DeliveryInf(68424, 91419), DeliveryInf(94361, 91419),
+                                               DeliveryInf(180613, 151301), DeliveryInf(127593, 64272)};
+        std::vector<IntersectionIdx> depots = {14187, 6615, 128524};
+        float turn_penalty = 30.0;
+
+        struct Reports {
+            std::mutex lock;
+            std::condition_variable changed;
+            int count = 0;
+            bool all_legal = true;
+            bool all_better = true;
+            double last_time = std::numeric_limits<double>::infinity();
+        };
+        auto reports = std::make_shared<Reports>();
+        auto on_improvement = [reports, deliveries, depots](const std::vector<CourierSubPath>& route, double travel_time) {
+            bool legal = courier_path_is_legal(deliveries, depots, route);
+            std::lock_guard<std::mutex> guard(reports->lock);
+            reports->count++;
+            reports->all_legal = reports->all_legal && legal;
+            reports->all_better = reports->all_better && travel_time < reports->last_time;
+            reports->last_time = travel_time;
+            reports->changed.notify_all();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<CourierSubPath> result = travelingCourierUntil(deliveries, depots, turn_penalty,
+                                                                   start + std::chrono::seconds(2),
+                                                                   CourierOptions(), on_improvement);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        CHECK(elapsed < 2.5);
+        CHECK(courier_path_is_legal(deliveries, depots, result));
+
+        double result_time = 0;
+        for (const CourierSubPath& leg : result) {
+            result_time += computePathTravelTime(leg.subpath, turn_penalty);
+        }
+        std::unique_lock<std::mutex> guard(reports->lock);
+        CHECK(reports->changed.wait_for(guard, std::chrono::seconds(5), [&]() {
+            return relative_error(result_time, reports->last_time) < 1e-3;
+        }));
+        CHECK(reports->count > 0);
+        CHECK(reports->all_legal);
+        CHECK(reports->all_better);
+    }
+}
@@ -0,0 +1,199 @@
+#include <random>
+#include <iostream>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m4.h"
+#include "courier/courier_problem.hpp"
+#include "courier/courier_tour.hpp"
+#include "courier/local_search.hpp"
+#include "courier/annealing.hpp"
+#include "courier/insertion.hpp"
+
+#include "unit_test_util.h"
+
+// Six deliveries (one shared pickUp, one shared dropOff) and three depots, turn penalty 30,
+// and the tour visiting each pickUp right before its dropOff
+struct CourierTourFixture {
+    std::vector<DeliveryInf> deliveries = {DeliveryInf(23285, 30394), DeliveryInf(65052, 98292), DeliveryInf(69434, 112840),
+                                           DeliveryInf(165581, 51879), DeliveryInf(76559, 147917), DeliveryInf(23285, 51879)};
+    std::vector<IntersectionIdx> depots = {82393, 91986, 83785};
+    CourierProblem problem = build_courier_problem(deliveries, depots, 30.0);
+    CourierTour tour;       // Points to problem
+
+    CourierTourFixture() {
+        std::vector<int> stops;
+        for (int delivery = 0; delivery < deliveries.size(); delivery++) {
+            stops.push_back(pickup_stop(delivery));
+            stops.push_back(dropoff_stop(delivery));
+        }
+        tour.assign(problem, stops);
+    }
+    CourierTourFixture(const CourierTourFixture&) = delete;
+};
+
+SUITE(courier_tour_toronto_canada) {
+    // Constant-time move deltas must match the travel time of the tour rebuilt after the move,
+    // and moves reported as infeasible must be exactly those that put a dropOff before its pickUp
+    TEST(courier_tour_move_deltas) {
+        CourierTourFixture fixture;
+        const std::vector<DeliveryInf>& deliveries = fixture.deliveries;
+        CourierTour tour = fixture.tour;
+
+        auto precedence_ok = [&](const CourierTour& candidate) {
+            for (int delivery = 0; delivery < deliveries.size(); delivery++) {
+                if (candidate.position[pickup_stop(delivery)] > candidate.position[dropoff_stop(delivery)]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        std::mt19937 rng(4);
+        int n = tour.size();
+        for (int iteration = 0; iteration < 2000; iteration++) {
+            int move = rng() % 3;
+            int i = rng() % n;
+            int j = rng() % n;
+            if (move == 0) {
+                int length = 1 + rng() % 3;
+                int after = (int) (rng() % (n + 1)) - 1;
+                if (i + length > n || (after >= i - 1 && after < i + length)) {
+                    continue;
+                }
+                double delta = tour.or_opt_delta(i, length, after);
+                CourierTour moved = tour;
+                moved.apply_or_opt(i, length, after);
+                CHECK_EQUAL(precedence_ok(moved), delta != INFEASIBLE_MOVE);
+                if (delta != INFEASIBLE_MOVE) {
+                    CHECK(std::fabs(moved.total_time - tour.total_time - delta) < 1e-3);
+                    tour = moved;
+                }
+            } else {
+                if (i >= j) {
+                    continue;
+                }
+                double delta = move == 1 ? tour.swap_delta(i, j) : tour.two_opt_delta(i, j);
+                CourierTour moved = tour;
+                if (move == 1) {
+                    moved.apply_swap(i, j);
+                } else {
+                    moved.apply_two_opt(i, j);
+                }
+                CHECK_EQUAL(precedence_ok(moved), delta != INFEASIBLE_MOVE);
+                if (delta != INFEASIBLE_MOVE) {
+                    CHECK(std::fabs(moved.total_time - tour.total_time - delta) < 1e-3);
+                    tour = moved;
+                }
+            }
+        }
+    }
+
+    // Local search must stop at a legal tour no longer than its seed, with no improving move left
+    TEST(courier_local_search_local_optimum) {
+        CourierTourFixture fixture;
+        const std::vector<DeliveryInf>& deliveries = fixture.deliveries;
+        CourierTour tour = fixture.tour;
+        double seed_time = tour.total_time;
+
+        LocalSearchStats stats = local_search(tour, std::chrono::steady_clock::now() + std::chrono::seconds(30));
+        CHECK(stats.local_optimum);
+        CHECK(tour.total_time <= seed_time);
+        CHECK_CLOSE(seed_time, stats.initial_time, 1e-6);
+        CHECK_CLOSE(tour.total_time, stats.final_time, 1e-6);
+
+        for (int delivery = 0; delivery < deliveries.size(); delivery++) {
+            CHECK(tour.position[pickup_stop(delivery)] < tour.position[dropoff_stop(delivery)]);
+        }
+        int n = tour.size();
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                CHECK(tour.two_opt_delta(i, j) >= -IMPROVEMENT_EPSILON);
+            }
+            for (int length = 1; length <= OR_OPT_MAX_LENGTH && i + length <= n; length++) {
+                for (int after = -1; after < n; after++) {
+                    if (after < i - 1 || after >= i + length) {
+                        CHECK(tour.or_opt_delta(i, length, after) >= -IMPROVEMENT_EPSILON);
+                    }
+                }
+            }
+        }
+    }
+
+    // Annealing must return a legal tour no longer than its seed, within its time budget
+    TEST(courier_simulated_annealing_best_tour) {
+        CourierTourFixture fixture;
+        const std::vector<DeliveryInf>& deliveries = fixture.deliveries;
+        const CourierTour& seed_tour = fixture.tour;
+
+        auto start_time = std::chrono::steady_clock::now();
+        CourierTour tour = simulated_annealing({seed_tour}, start_time + std::chrono::milliseconds(500), 7);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        CHECK(elapsed < 1.0);
+        CHECK(tour.total_time <= seed_tour.total_time);
+        CHECK_EQUAL(seed_tour.size(), tour.size());
+        for (int delivery = 0; delivery < deliveries.size(); delivery++) {
+            CHECK(tour.position[pickup_stop(delivery)] < tour.position[dropoff_stop(delivery)]);
+        }
+
+        const AnnealingStats& stats = last_annealing_stats();
+        CHECK(stats.moves_evaluated > 0);
+        CHECK_CLOSE(tour.total_time, stats.final_time, 1e-6);
+    }
+
+    // With a move budget, the same seed must give the same tour whatever the thread timing
+    TEST(courier_simulated_annealing_deterministic) {
+        CourierTourFixture fixture;
+        const CourierTour& seed_tour = fixture.tour;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        CourierTour first = simulated_annealing({seed_tour}, deadline, 11, 20000);
+        CourierTour second = simulated_annealing({seed_tour}, deadline, 11, 20000);
+        CHECK(first.stops == second.stops);
+        CHECK_EQUAL(first.total_time, second.total_time);
+    }
+
+    // The default budget of seeded runs must only depend on the tour size, in whole epochs
+    TEST(courier_annealing_move_budget) {
+        CourierTourFixture fixture;
+        const CourierTour& seed_tour = fixture.tour;
+
+        long long budget = annealing_move_budget(seed_tour);
+        CHECK(budget > 0);
+        CHECK_EQUAL(0, budget % 1000);
+        CHECK_EQUAL(budget, annealing_move_budget(seed_tour));
+
+        CourierProblem one_delivery = build_courier_problem({fixture.deliveries[0]}, fixture.depots, 30.0);
+        CourierTour shorter;
+        shorter.assign(one_delivery, {pickup_stop(0), dropoff_stop(0)});
+        CHECK(annealing_move_budget(shorter) > 0);
+        CHECK(annealing_move_budget(shorter) < budget);
+    }
+
+    // Insertion constructions must be complete legal tours, distinct and sorted best first
+    TEST(courier_insertion_population) {
+        CourierTourFixture fixture;
+        const std::vector<DeliveryInf>& deliveries = fixture.deliveries;
+        const CourierProblem& problem = fixture.problem;
+
+        std::vector<CourierTour> population = construct_population(problem, 16, 3, 0,
+                                                                   std::chrono::steady_clock::now() + std::chrono::seconds(30));
+        CHECK(!population.empty());
+        for (int member = 0; member < population.size(); member++) {
+            const CourierTour& tour = population[member];
+            CHECK_EQUAL(2 * (int) deliveries.size(), tour.size());
+            for (int delivery = 0; delivery < deliveries.size(); delivery++) {
+                CHECK(tour.position[pickup_stop(delivery)] < tour.position[dropoff_stop(delivery)]);
+            }
+            if (member > 0) {
+                CHECK(population[member - 1].total_time <= tour.total_time);
+                CHECK(population[member - 1].stops != tour.stops);
+            }
+        }
+
+        // Regret-1 (plain cheapest insertion) builds a complete tour too
+        std::vector<int> stops = regret_insertion(problem, 0, 1);
+        CHECK_EQUAL(2 * (int) deliveries.size(), (int) stops.size());
+    }
+}
@@ -0,0 +1,85 @@
+#include <random>
+#include <iostream>
+#include <chrono>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "m4.h"
+#include "courier/fleet.hpp"
+
+#include "unit_test_util.h"
+#include "courier_verify.h"
+
+using ece297test::fleet_paths_are_legal;
+
+
+SUITE(fleet_toronto_canada) {
+    // Every delivery served by one of the vehicles, within capacity, for both objectives,
+    // vehicles based at the depots in turn
+    TEST(fleet_legal_with_capacity) {
+        std::vector<DeliveryInf> deliveries = {DeliveryInf(124331, 156932), DeliveryInf(25964, 156932), DeliveryInf(67812, 156932),
+                                               DeliveryInf(153404, 97799), DeliveryInf(68424, 91419), DeliveryInf(94361, 91419),
+                                               DeliveryInf(180613, 151301), DeliveryInf(127593, 64272), DeliveryInf(23285, 30394)};
+        std::vector<IntersectionIdx> depots = {14187, 6615, 128524};
+        float turn_penalty = 30.0;
+
+        CourierOptions options;
+        options.seed = 297;
+        options.time_budget = 2;
+        for (FleetObjective objective : {FleetObjective::TOTAL_TIME, FleetObjective::MAKESPAN}) {
+            FleetOptions fleet;
+            fleet.num_vehicles = 3;
+            fleet.capacity = 2;
+            fleet.objective = objective;
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::vector<CourierSubPath>> routes = travelingCouriers(deliveries, depots, turn_penalty, fleet, options);
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            CHECK(elapsed < 3.0);
+            CHECK_EQUAL(3, routes.size());
+            CHECK(fleet_paths_are_legal(deliveries, depots, routes, fleet.capacity, depots));
+        }
+    }
+
+    // Vehicles sharing the depot they are given, and depots that are not among the depots rejected
+    TEST(fleet_vehicle_depots) {
+        std::vector<DeliveryInf> deliveries = {DeliveryInf(124331, 156932), DeliveryInf(153404, 97799), DeliveryInf(68424, 91419),
+                                               DeliveryInf(180613, 151301), DeliveryInf(23285, 30394)};
+        std::vector<IntersectionIdx> depots = {14187, 6615, 128524};
+        float turn_penalty = 15.0;
+
+        CourierOptions options;
+        options.seed = 297;
+        options.time_budget = 1;
+        FleetOptions fleet;
+        fleet.num_vehicles = 3;
+        fleet.vehicle_depots = {6615, 6615, 128524};
+        std::vector<std::vector<CourierSubPath>> routes = travelingCouriers(deliveries, depots, turn_penalty, fleet, options);
+        CHECK_EQUAL(3, routes.size());
+        CHECK(fleet_paths_are_legal(deliveries, depots, routes, 0, fleet.vehicle_depots));
+
+        fleet.vehicle_depots = {6615, 6615, 30394};
+        CHECK(travelingCouriers(deliveries, depots, turn_penalty, fleet, options).empty());
+        fleet.vehicle_depots = {6615};
+        CHECK(travelingCouriers(deliveries, depots, turn_penalty, fleet, options).empty());
+    }
+
+    // Only one vehicle with no capacity: a regular courier route
+    TEST(fleet_single_vehicle) {
+        std::vector<DeliveryInf> deliveries = {DeliveryInf(23285, 30394), DeliveryInf(68424, 91419), DeliveryInf(153404, 97799)};
+        std::vector<IntersectionIdx> depots = {82393, 91986, 83785};
+        float turn_penalty = 15.0;
+
+        CourierOptions options;
+        options.seed = 297;
+        options.time_budget = 1;
+        std::vector<std::vector<CourierSubPath>> routes = travelingCouriers(deliveries, depots, turn_penalty, FleetOptions(), options);
+
+        CHECK_EQUAL(1, routes.size());
+        CHECK(fleet_paths_are_legal(deliveries, depots, routes, 0, {depots[0]}));
+        CHECK(ece297test::courier_path_is_legal(deliveries, depots, routes[0]));
+    }
+}
@@ -0,0 +1,135 @@
+#include <random>
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "m4.h"
+#include "courier/courier_solver.hpp"
+#include "routing/path_cache.hpp"
+
+#include "unit_test_util.h"
+#include "courier_verify.h"
+
+using ece297test::relative_error;
+using ece297test::courier_path_is_legal;
+using ece297test::compute_courier_path_travel_time;
+
+
+SUITE(path_cache_toronto_canada) {
+    // A repeated courier call is answered from the cache, with the same route
+    TEST(path_cache_repeated_courier) {
+        std::vector<DeliveryInf> deliveries = {DeliveryInf(23285, 30394), DeliveryInf(68424, 91419), DeliveryInf(153404, 97799),
+                                               DeliveryInf(124331, 156932), DeliveryInf(180613, 151301)};
+        std::vector<IntersectionIdx> depots = {82393, 91986, 83785};
+        float turn_penalty = 15.0;
+        CourierOptions options;
+        options.seed = 297;
+        options.num_threads = 1;
+        options.max_moves = 20000;
+
+        clear_path_cache();
+        reset_path_cache_stats();
+        std::vector<CourierSubPath> first = travelingCourier(deliveries, depots, turn_penalty, options);
+        PathCacheStats cold = path_cache_stats();
+        std::vector<CourierSubPath> second = travelingCourier(deliveries, depots, turn_penalty, options);
+        PathCacheStats warm = path_cache_stats();
+
+        CHECK(cold.misses > 0);
+        CHECK(warm.hits > cold.hits);
+        CHECK_EQUAL(cold.misses, warm.misses);
+        CHECK(courier_path_is_legal(deliveries, depots, second));
+        CHECK(relative_error(compute_courier_path_travel_time(first, turn_penalty),
+                             compute_courier_path_travel_time(second, turn_penalty)) < 1e-6);
+    }
+
+    // Hits and misses of a matrix are counted per entry, also in rows that are searched again
+    TEST(path_cache_matrix_stats) {
+        std::vector<IntersectionIdx> points = {23285, 30394, 65052};
+        clear_path_cache();
+        reset_path_cache_stats();
+        path_cache_insert(points[0], points[1], 15, 100);
+        cached_travel_time_matrix(points, 15);
+        CHECK_EQUAL(1, path_cache_stats().hits);
+        CHECK_EQUAL(8, path_cache_stats().misses);
+        cached_travel_time_matrix(points, 15);
+        CHECK_EQUAL(10, path_cache_stats().hits);
+        CHECK_EQUAL(8, path_cache_stats().misses);
+        clear_path_cache();
+    }
+
+    // Switching cities saves the entries of the old map under its own name, and switching back loads them
+    TEST(path_cache_survives_city_change) {
+        std::string toronto = CURRENT_MAP_PATH;
+        std::string hamilton = "/cad2/ece297s/public/maps/hamilton_canada.streets.bin";
+        clear_path_cache();
+        path_cache_insert(1, 2, 0, 10);
+        path_cache_insert(2, 3, 0, 20, {5, 6});
+
+        // As city_change_cbk does: the new map path is set before closeMap
+        CURRENT_MAP_PATH = hamilton;
+        closeMap();
+        CHECK(loadMap(hamilton));
+        float cost = 0;
+        CHECK(!path_cache_lookup(1, 2, 0, cost));
+
+        CURRENT_MAP_PATH = toronto;
+        closeMap();
+        CHECK(loadMap(toronto));
+        std::vector<StreetSegmentIdx> segments;
+        CHECK(path_cache_lookup(1, 2, 0, cost));
+        CHECK_EQUAL(10, cost);
+        CHECK(path_cache_lookup(2, 3, 0, cost, &segments));
+        CHECK(segments == std::vector<StreetSegmentIdx>({5, 6}));
+        clear_path_cache();
+    }
+
+    // Least recently used entries go first; saved entries load back for the same map
+    TEST(path_cache_eviction_and_file) {
+        long long capacity = PATH_CACHE_CAPACITY;
+        PATH_CACHE_CAPACITY = 2;
+        clear_path_cache();
+        reset_path_cache_stats();
+        path_cache_insert(1, 2, 0, 10);
+        path_cache_insert(2, 3, 0, 20, {5, 6});
+        float cost = 0;
+        CHECK(path_cache_lookup(1, 2, 0, cost));
+        path_cache_insert(3, 4, 0, 30);
+        CHECK(!path_cache_lookup(2, 3, 0, cost));
+        CHECK(path_cache_lookup(1, 2, 0, cost));
+        CHECK_EQUAL(10, cost);
+        CHECK(!path_cache_lookup(1, 2, 15, cost));
+        CHECK_EQUAL(1, path_cache_stats().evictions);
+
+        std::vector<StreetSegmentIdx> segments;
+        path_cache_insert(2, 3, 0, 20, {5, 6});
+        std::string filename = "path_cache_test.bin";
+        CHECK(save_path_cache(filename));
+        clear_path_cache();
+        CHECK(!path_cache_lookup(2, 3, 0, cost));
+        CHECK(load_path_cache(filename));
+        CHECK(path_cache_lookup(2, 3, 0, cost, &segments));
+        CHECK_EQUAL(20, cost);
+        CHECK(segments == std::vector<StreetSegmentIdx>({5, 6}));
+        CHECK(!path_cache_lookup(1, 2, 0, cost, &segments));
+
+        // A truncated file loads no entry at all
+        std::string contents;
+        {
+            std::ifstream file(filename, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        std::ofstream(filename, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() - 4);
+        clear_path_cache();
+        CHECK(!load_path_cache(filename));
+        CHECK_EQUAL(0, path_cache_stats().entries);
+        std::remove(filename.c_str());
+
+        PATH_CACHE_CAPACITY = capacity;
+        clear_path_cache();
+    }
+}
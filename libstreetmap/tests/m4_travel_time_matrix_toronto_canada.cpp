@@ -0,0 +1,129 @@
+#include <iostream>
+#include <algorithm>
+#include <UnitTest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "routing/routing.hpp"
+#include "routing/contraction_hierarchy.hpp"
+#include "routing/travel_time_matrix.hpp"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+
+// The hierarchy is built once for the whole test run: hidden (not cleared) to test the one-to-many searches
+static double hidden_turn_penalty = -1;
+static void use_contraction_hierarchy(bool use_hierarchy, double turn_penalty) {
+    if (hidden_turn_penalty >= 0) {
+        Contraction_Hierarchy.turn_penalty = hidden_turn_penalty;
+        hidden_turn_penalty = -1;
+    }
+    if (use_hierarchy) {
+        ensure_contraction_hierarchy(turn_penalty);
+    } else {
+        hidden_turn_penalty = Contraction_Hierarchy.turn_penalty;
+        Contraction_Hierarchy.turn_penalty = -1;
+    }
+}
+
+SUITE(travel_time_matrix_toronto_canada) {
+    // Every entry of the matrix must match a point-to-point query, with and without the hierarchy
+    TEST(matrix_vs_point_to_point) {
+        std::vector<IntersectionIdx> points = {23285, 30394, 65052, 98292, 69434, 112840, 165581, 51879, 76559, 23285};
+        double turn_penalty = 15.0;
+
+        for (bool use_hierarchy : {false, true}) {
+            use_contraction_hierarchy(use_hierarchy, turn_penalty);
+            TravelTimeMatrix matrix = compute_travel_time_matrix(points, points, turn_penalty);
+            for (int from = 0; from < points.size(); from++) {
+                for (int to = 0; to < points.size(); to++) {
+                    auto [travel_time, path] = findPathAndTravelTime({points[from], points[to]}, turn_penalty, PathSearchMode::EDGE_BASED);
+                    CHECK(matrix.has_path(from, to));
+                    CHECK(relative_error((double) matrix.cost(from, to), travel_time) < 1e-6);
+                    if (points[from] != points[to]) {
+                        std::vector<StreetSegmentIdx> matrix_path = matrix.path(from, to);
+                        CHECK(path_is_legal(points[from], points[to], matrix_path));
+                        CHECK(relative_error(computePathTravelTime(matrix_path, turn_penalty), travel_time) < 1e-9);
+                    }
+                }
+            }
+        }
+    }
+
+    // A path exists exactly when the component of the target is reachable from the component of the source
+    TEST(matrix_reachable_components) {
+        std::vector<IntersectionIdx> points = {23285, 30394, 65052, 98292, 69434, 112840, 165581, 51879, 76559, 0, 1, 2};
+        double turn_penalty = 15.0;
+        CHECK_EQUAL(getNumIntersections(), Routing_Graph.component.size());
+        use_contraction_hierarchy(false, turn_penalty);
+        TravelTimeMatrix matrix = compute_travel_time_matrix(points, points, turn_penalty);
+        for (int from = 0; from < points.size(); from++) {
+            std::vector<char> reachable = reachable_components(Routing_Graph.component[points[from]]);
+            for (int to = 0; to < points.size(); to++) {
+                CHECK_EQUAL((bool) reachable[Routing_Graph.component[points[to]]], matrix.has_path(from, to));
+            }
+        }
+    }
+
+    // Bounded searches keep exactly the entries of the full matrix within the bound / among the nearest targets
+    TEST(matrix_bounded_searches) {
+        std::vector<IntersectionIdx> points = {23285, 30394, 65052, 98292, 69434, 112840, 165581, 51879, 76559, 23285};
+        double turn_penalty = 15.0;
+        int n = points.size();
+        use_contraction_hierarchy(false, turn_penalty);
+        TravelTimeMatrix full = compute_travel_time_matrix(points, points, turn_penalty);
+        std::vector<float> sorted_costs(full.costs);
+        std::sort(sorted_costs.begin(), sorted_costs.end());
+        // Halfway between two matrix entries, so that float rounding of the costs cannot matter
+        int middle = sorted_costs.size() / 2;
+        while (middle + 1 < sorted_costs.size() && sorted_costs[middle + 1] == sorted_costs[middle]) {
+            middle++;
+        }
+        double max_travel_time = (sorted_costs[middle] + (double) sorted_costs[middle + 1]) / 2;
+
+        for (bool use_hierarchy : {false, true}) {
+            use_contraction_hierarchy(use_hierarchy, turn_penalty);
+            MatrixSearchBounds within_time;
+            within_time.max_travel_time = max_travel_time;
+            TravelTimeMatrix bounded = compute_travel_time_matrix(points, points, turn_penalty, within_time);
+            for (int i = 0; i < n * n; i++) {
+                CHECK_EQUAL(full.costs[i] <= max_travel_time, bounded.costs[i] < FLT_MAX);
+                if (bounded.costs[i] < FLT_MAX) {
+                    CHECK(relative_error((double) bounded.costs[i], (double) full.costs[i]) < 1e-6);
+                }
+            }
+
+            // 3 nearest other intersections (23285 appears twice, both copies are filled)
+            MatrixSearchBounds nearest;
+            nearest.nearest_targets = 3;
+            TravelTimeMatrix local = compute_travel_time_matrix(points, points, turn_penalty, nearest);
+            for (int from = 0; from < n; from++) {
+                std::vector<std::pair<float, IntersectionIdx>> others;
+                std::vector<IntersectionIdx> found;
+                for (int to = 0; to < n; to++) {
+                    if (points[to] != points[from]) {
+                        others.push_back(std::make_pair(full.cost(from, to), points[to]));
+                        if (local.has_path(from, to)) {
+                            found.push_back(points[to]);
+                            CHECK(relative_error((double) local.cost(from, to), (double) full.cost(from, to)) < 1e-6);
+                        }
+                    }
+                }
+                std::sort(others.begin(), others.end());
+                others.erase(std::unique(others.begin(), others.end()), others.end());
+                std::sort(found.begin(), found.end());
+                found.erase(std::unique(found.begin(), found.end()), found.end());
+                CHECK_EQUAL(3, found.size());
+                for (const auto& other : others) {
+                    bool is_found = std::find(found.begin(), found.end(), other.second) != found.end();
+                    CHECK(!is_found || other.first <= others[2].first);
+                }
+            }
+        }
+    }
+}